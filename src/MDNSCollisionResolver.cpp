@@ -0,0 +1,388 @@
+/*
+ * MDNSCollisionResolver.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include "MDNSCollisionResolver.hpp"
+#include "MDNSPacket.hpp"
+#include <sstream>
+#include <stdexcept>
+
+namespace MDNS
+{
+
+namespace
+{
+
+const std::size_t MAX_LABEL_SIZE = 63;
+
+/** Shorten s to at most size bytes without splitting a UTF-8 sequence */
+std::string truncateUtf8(const std::string &s, std::size_t size)
+{
+    if (s.size() <= size)
+        return s;
+    while (size > 0 && (static_cast<unsigned char>(s[size]) & 0xC0) == 0x80)
+        --size;
+    return s.substr(0, size);
+}
+
+std::string normalizeDomain(const std::string &domain)
+{
+    return domain.empty() ? std::string("local") : domain;
+}
+
+} // namespace
+
+std::string makeAlternativeServiceName(const std::string &baseName, std::uint32_t attempt,
+                                       MDNSRenameStrategy strategy, const std::string &hostId)
+{
+    std::ostringstream counter;
+    if (attempt > 0)
+        counter << " #" << attempt + 1;
+
+    std::string suffix;
+    if (strategy == MDNS_RENAME_HOST_SUFFIX && !hostId.empty())
+    {
+        // Keep the counter and at least one byte of the base name
+        const std::size_t maxHostSize = MAX_LABEL_SIZE - counter.str().size() - 4;
+        suffix = " (" + truncateUtf8(hostId, maxHostSize) + ")";
+    }
+    suffix += counter.str();
+    return truncateUtf8(baseName, MAX_LABEL_SIZE - suffix.size()) + suffix;
+}
+
+// MDNSNameRegistry
+
+MDNSNameRegistry::MDNSNameRegistry()
+{
+}
+
+MDNSNameRegistry::TypeKey MDNSNameRegistry::makeTypeKey(const std::string &type, const std::string &domain)
+{
+    return toLower(type + "." + normalizeDomain(domain));
+}
+
+std::string MDNSNameRegistry::toLower(const std::string &s)
+{
+    std::string result(s);
+    for (std::string::iterator it = result.begin(), iend = result.end(); it != iend; ++it)
+    {
+        if (*it >= 'A' && *it <= 'Z')
+            *it = static_cast<char>(*it - 'A' + 'a');
+    }
+    return result;
+}
+
+std::string MDNSNameRegistry::makeFirstFreeKey(const std::string &name, MDNSRenameStrategy strategy, const std::string &hostId)
+{
+    std::string key = toLower(name);
+    key += '\0';
+    if (strategy == MDNS_RENAME_HOST_SUFFIX)
+        key += hostId;
+    return key;
+}
+
+std::uint32_t MDNSNameRegistry::findFree(const Names &names, const std::string &name,
+                                         MDNSRenameStrategy strategy, const std::string &hostId)
+{
+    std::uint32_t attempt = 0;
+    auto hint = names.firstFree.find(makeFirstFreeKey(name, strategy, hostId));
+    if (hint != names.firstFree.end())
+        attempt = hint->second;
+
+    // Candidates of different attempts differ, one of the next taken + 1 is free
+    const std::size_t maxAttempts = names.seen.size() + names.reserved.size() + names.conflicts.size() + 1;
+    for (std::size_t i = 0; i < maxAttempts; ++i, ++attempt)
+    {
+        if (!names.isTaken(toLower(makeAlternativeServiceName(name, attempt, strategy, hostId))))
+            return attempt;
+    }
+    throw std::runtime_error("MDNSNameRegistry: no free name for " + name);
+}
+
+std::string MDNSNameRegistry::reserveLocked(Names &names, const std::string &name, MDNSRenameStrategy strategy, const std::string &hostId)
+{
+    const std::uint32_t attempt = findFree(names, name, strategy, hostId);
+    const std::string candidate = makeAlternativeServiceName(name, attempt, strategy, hostId);
+    names.reserved.insert(toLower(candidate));
+    names.firstFree[makeFirstFreeKey(name, strategy, hostId)] = attempt + 1;
+    return candidate;
+}
+
+std::string MDNSNameRegistry::reserve(const std::string &name, const std::string &type, const std::string &domain,
+                                      MDNSRenameStrategy strategy, const std::string &hostId)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return reserveLocked(names_[makeTypeKey(type, domain)], name, strategy, hostId);
+}
+
+std::string MDNSNameRegistry::pick(const std::string &name, const std::string &type, const std::string &domain,
+                                   MDNSRenameStrategy strategy, const std::string &hostId) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = names_.find(makeTypeKey(type, domain));
+    if (it == names_.end())
+        return makeAlternativeServiceName(name, 0, strategy, hostId);
+    return makeAlternativeServiceName(name, findFree(it->second, name, strategy, hostId), strategy, hostId);
+}
+
+std::string MDNSNameRegistry::resolveCollision(const std::string &oldName, const std::string &newName,
+                                               const std::string &requestedName, const std::string &type, const std::string &domain,
+                                               MDNSRenameStrategy strategy, const std::string &hostId)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Names &names = names_[makeTypeKey(type, domain)];
+    const std::string oldKey = toLower(oldName);
+    names.reserved.erase(oldKey);
+    names.conflicts.insert(oldKey);
+
+    const std::string newKey = toLower(newName);
+    if (!names.isTaken(newKey))
+    {
+        names.reserved.insert(newKey);
+        return newName;
+    }
+    // The backend renamed blindly, use a name that is known to be free
+    return reserveLocked(names, requestedName, strategy, hostId);
+}
+
+void MDNSNameRegistry::release(const std::string &name, const std::string &type, const std::string &domain)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = names_.find(makeTypeKey(type, domain));
+    if (it != names_.end() && it->second.reserved.erase(toLower(name)))
+        it->second.firstFree.clear();
+}
+
+void MDNSNameRegistry::addConflict(const std::string &name, const std::string &type, const std::string &domain)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    names_[makeTypeKey(type, domain)].conflicts.insert(toLower(name));
+}
+
+bool MDNSNameRegistry::isTaken(const std::string &name, const std::string &type, const std::string &domain) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = names_.find(makeTypeKey(type, domain));
+    if (it == names_.end())
+        return false;
+    return it->second.isTaken(toLower(name));
+}
+
+std::size_t MDNSNameRegistry::getSeenCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::size_t count = 0;
+    for (auto it = names_.begin(), iend = names_.end(); it != iend; ++it)
+        count += it->second.seen.size();
+    return count;
+}
+
+void MDNSNameRegistry::onNewService(const MDNSService &service)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++names_[makeTypeKey(service.getType(), service.getDomain())].seen[toLower(service.getName())];
+}
+
+void MDNSNameRegistry::onRemovedService(const std::string &name, const std::string &type, const std::string &domain, MDNSInterfaceIndex interfaceIndex)
+{
+    (void)interfaceIndex;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto names = names_.find(makeTypeKey(type, domain));
+    if (names == names_.end())
+        return;
+    const std::string key = toLower(name);
+    auto it = names->second.seen.find(key);
+    if (it != names->second.seen.end() && --it->second == 0)
+    {
+        names->second.seen.erase(it);
+        names->second.conflicts.erase(key);
+        names->second.firstFree.clear();
+    }
+}
+
+// MDNSCollisionResolver
+
+MDNSCollisionResolver::MDNSCollisionResolver(MDNSManager &manager, const Options &options)
+    : manager_(manager)
+    , options_(options)
+    , registry_(std::make_shared<MDNSNameRegistry>())
+    , reregisterTimer_([this]() { reregisterPending(); })
+{
+    if (options_.strategy == MDNS_RENAME_HOST_SUFFIX && options_.hostId.empty())
+        options_.hostId = getDefaultHostId();
+
+    manager_.setAlternativeServiceNameHandler([this](const std::string &newName, const std::string &oldName)
+    {
+        onAlternativeServiceName(newName, oldName);
+    });
+}
+
+MDNSCollisionResolver::~MDNSCollisionResolver()
+{
+    manager_.setAlternativeServiceNameHandler(MDNSManager::AlternativeServiceNameHandler());
+    bool browsing;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        browsing = !watched_.empty();
+    }
+    if (browsing)
+        manager_.unregisterServiceBrowser(registry_);
+}
+
+void MDNSCollisionResolver::setAlternativeServiceNameHandler(const MDNSManager::AlternativeServiceNameHandler &handler)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    alternativeServiceNameHandler_ = handler;
+}
+
+void MDNSCollisionResolver::watchType(const std::string &type, const std::string &domain)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!watched_.insert(std::make_pair(type, normalizeDomain(domain))).second)
+            return;
+    }
+    manager_.registerServiceBrowser(registry_, MDNS_IF_ANY, type, domain);
+}
+
+void MDNSCollisionResolver::registerService(MDNSService &service)
+{
+    watchType(service.getType(), service.getDomain());
+
+    Registration registration;
+    registration.requestedName = service.getName();
+    registration.type = service.getType();
+    registration.domain = service.getDomain();
+    registration.name = registry_->reserve(service.getName(), service.getType(), service.getDomain(),
+                                           options_.strategy, options_.hostId);
+    if (registration.name != service.getName())
+        service.setName(registration.name);
+    registration.registered = std::make_shared<MDNSService>(service);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.registered;
+        if (registration.name != registration.requestedName)
+            ++stats_.renamedBeforeProbing;
+        registrations_[&service] = registration;
+    }
+    manager_.registerService(*registration.registered);
+}
+
+void MDNSCollisionResolver::unregisterService(MDNSService &service)
+{
+    std::lock_guard<std::mutex> reregisterLock(reregisterMutex_);
+    Registration registration;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pendingReregistrations_.erase(&service);
+        auto it = registrations_.find(&service);
+        if (it == registrations_.end())
+        {
+            registration.name = service.getName();
+            registration.type = service.getType();
+            registration.domain = service.getDomain();
+        }
+        else
+        {
+            registration = it->second;
+            registrations_.erase(it);
+        }
+    }
+    manager_.unregisterService(registration.registered ? *registration.registered : service);
+    registry_->release(registration.name, registration.type, registration.domain);
+}
+
+std::string MDNSCollisionResolver::pickName(const std::string &name, const std::string &type, const std::string &domain) const
+{
+    return registry_->pick(name, type, domain, options_.strategy, options_.hostId);
+}
+
+MDNSCollisionResolver::Stats MDNSCollisionResolver::getStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void MDNSCollisionResolver::onAlternativeServiceName(const std::string &newName, const std::string &oldName)
+{
+    MDNSManager::AlternativeServiceNameHandler handler;
+    MDNSService *service = 0;
+    Registration registration;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.collisions;
+        handler = alternativeServiceNameHandler_;
+        // Only the name is reported, it must identify a single type and domain
+        bool ambiguous = false;
+        for (auto it = registrations_.begin(), iend = registrations_.end(); it != iend; ++it)
+        {
+            if (!equalNames(it->second.name, oldName))
+                continue;
+            if (service && !(equalNames(it->second.type, registration.type) &&
+                             equalNames(normalizeDomain(it->second.domain), normalizeDomain(registration.domain))))
+                ambiguous = true;
+            service = it->first;
+            registration = it->second;
+        }
+        if (ambiguous)
+            service = 0;
+    }
+
+    std::string name = newName;
+    if (service)
+    {
+        name = registry_->resolveCollision(oldName, newName, registration.requestedName, registration.type,
+                                           registration.domain, options_.strategy, options_.hostId);
+
+        bool reregister = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = registrations_.find(service);
+            if (it != registrations_.end())
+            {
+                it->second.name = name;
+                if (name != newName)
+                {
+                    // Calling the manager from its own callback is not allowed
+                    ++stats_.reregistered;
+                    pendingReregistrations_.insert(service);
+                    reregister = true;
+                }
+            }
+        }
+        if (reregister)
+            reregisterTimer_.arm(MDNSDeadlineTimer::Clock::now());
+    }
+
+    if (handler)
+        handler(name, oldName);
+}
+
+void MDNSCollisionResolver::reregisterPending()
+{
+    std::lock_guard<std::mutex> reregisterLock(reregisterMutex_);
+    std::vector<std::pair<std::shared_ptr<MDNSService>, std::string> > pending;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto it = pendingReregistrations_.begin(), iend = pendingReregistrations_.end(); it != iend; ++it)
+        {
+            auto registration = registrations_.find(*it);
+            if (registration != registrations_.end())
+                pending.push_back(std::make_pair(registration->second.registered, registration->second.name));
+        }
+        pendingReregistrations_.clear();
+    }
+
+    // Only the resolver's copies are touched, and only while the manager
+    // does not reference them
+    for (auto it = pending.begin(), iend = pending.end(); it != iend; ++it)
+    {
+        manager_.unregisterService(*it->first);
+        it->first->setName(it->second);
+        manager_.registerService(*it->first);
+    }
+}
+
+} // namespace MDNS
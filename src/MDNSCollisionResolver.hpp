@@ -0,0 +1,248 @@
+/*
+ * MDNSCollisionResolver.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef MDNSCOLLISIONRESOLVER_HPP_INCLUDED
+#define MDNSCOLLISIONRESOLVER_HPP_INCLUDED
+
+#include "MDNSManager.hpp"
+#include "MDNSEpoch.hpp"
+#include "MDNSHostId.hpp"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace MDNS
+{
+
+enum MDNSRenameStrategy
+{
+    /** "Name", "Name #2", "Name #3", ... like Avahi and Bonjour */
+    MDNS_RENAME_SEQUENTIAL,
+    /**
+     * "Name (host)", "Name (host) #2", ... Hosts starting identically named
+     * services at the same time pick different names in the first attempt,
+     * and every host gets the same names again after a restart.
+     */
+    MDNS_RENAME_HOST_SUFFIX
+};
+
+/**
+ * Candidate name number attempt (starting with 0) of the strategy, the base
+ * name is shortened on a UTF-8 boundary to fit into a 63 byte label. A long
+ * host id is shortened as well, so that every attempt yields another name.
+ */
+std::string makeAlternativeServiceName(const std::string &baseName, std::uint32_t attempt,
+                                       MDNSRenameStrategy strategy, const std::string &hostId);
+
+/**
+ * Service instance names seen by a browser plus names reserved locally,
+ * per type and domain. Comparison is ASCII case-insensitive like in DNS.
+ */
+class MDNSNameRegistry : public MDNSServiceBrowser
+{
+public:
+
+    typedef std::shared_ptr<MDNSNameRegistry> Ptr;
+
+    MDNSNameRegistry();
+
+    /**
+     * Reserve the first candidate for name that is neither seen nor reserved,
+     * returns the reserved name.
+     */
+    std::string reserve(const std::string &name, const std::string &type, const std::string &domain,
+                        MDNSRenameStrategy strategy, const std::string &hostId);
+
+    /** First candidate reserve() would choose now, without reserving it */
+    std::string pick(const std::string &name, const std::string &type, const std::string &domain,
+                     MDNSRenameStrategy strategy, const std::string &hostId) const;
+
+    /**
+     * The backend renamed oldName to newName after a collision. Marks oldName
+     * as conflicting and reserves newName if it is free, otherwise the first
+     * free candidate for requestedName. Returns the reserved name.
+     */
+    std::string resolveCollision(const std::string &oldName, const std::string &newName,
+                                 const std::string &requestedName, const std::string &type, const std::string &domain,
+                                 MDNSRenameStrategy strategy, const std::string &hostId);
+
+    void release(const std::string &name, const std::string &type, const std::string &domain);
+
+    /** Name collided, treat it as taken until its owner is seen to go away */
+    void addConflict(const std::string &name, const std::string &type, const std::string &domain);
+
+    bool isTaken(const std::string &name, const std::string &type, const std::string &domain) const;
+
+    std::size_t getSeenCount() const;
+
+    void onNewService(const MDNSService &service) override;
+
+    void onRemovedService(const std::string &name, const std::string &type, const std::string &domain, MDNSInterfaceIndex interfaceIndex) override;
+
+private:
+
+    /** Lower case "type.domain" */
+    typedef std::string TypeKey;
+
+    struct Names
+    {
+        /** Lower case instance name to number of interfaces it was seen on */
+        std::map<std::string, unsigned int> seen;
+        std::set<std::string> reserved;
+        std::set<std::string> conflicts;
+        /**
+         * Per base name, strategy and host id the attempt below which all
+         * candidates are taken, cleared whenever a name becomes free
+         */
+        std::map<std::string, std::uint32_t> firstFree;
+
+        bool isTaken(const std::string &key) const
+        {
+            return seen.count(key) != 0 || reserved.count(key) != 0 || conflicts.count(key) != 0;
+        }
+    };
+
+    static TypeKey makeTypeKey(const std::string &type, const std::string &domain);
+    static std::string toLower(const std::string &s);
+    static std::string makeFirstFreeKey(const std::string &name, MDNSRenameStrategy strategy, const std::string &hostId);
+
+    /** Attempt of the first free candidate, called with mutex_ held */
+    static std::uint32_t findFree(const Names &names, const std::string &name,
+                                  MDNSRenameStrategy strategy, const std::string &hostId);
+    std::string reserveLocked(Names &names, const std::string &name, MDNSRenameStrategy strategy, const std::string &hostId);
+
+    mutable std::mutex mutex_;
+    std::map<TypeKey, Names> names_;
+};
+
+/**
+ * Registers services through MDNSManager under names that are free according
+ * to the browse cache, instead of letting every instance probe, collide and
+ * rename one attempt at a time.
+ *
+ * The resolver browses every type it registers services for. Call watchType()
+ * early, e.g. at startup, so that the cache is filled before services are
+ * registered. Every service is registered on its own. When the backend reports
+ * a collision and its new name is already known to be taken, only the colliding
+ * service is registered again under a free name. This happens on a worker
+ * thread after the manager's callback returned, the manager is not called back
+ * from within its own handler.
+ *
+ * The resolver registers a copy of each service that it owns, so that the
+ * worker thread never touches objects of the caller.
+ *
+ * The manager reports collisions by instance name only. When several
+ * registered services of different types share the colliding name, the
+ * registration can't be identified and the backend's new name is kept.
+ *
+ * The resolver installs the alternative service name handler of the manager,
+ * set handlers through the resolver instead. They get the final name.
+ */
+class MDNSCollisionResolver
+{
+public:
+
+    struct Options
+    {
+        MDNSRenameStrategy strategy;
+        /** Host suffix for MDNS_RENAME_HOST_SUFFIX, defaults to getDefaultHostId() */
+        std::string hostId;
+
+        Options(MDNSRenameStrategy strategy = MDNS_RENAME_SEQUENTIAL, const std::string &hostId = std::string())
+            : strategy(strategy), hostId(hostId)
+        { }
+    };
+
+    struct Stats
+    {
+        /** Services registered through the resolver */
+        std::uint64_t registered;
+        /** Services registered under another name than requested */
+        std::uint64_t renamedBeforeProbing;
+        /** Renames by the backend after a collision */
+        std::uint64_t collisions;
+        /** Services registered again because the backend's new name was known to be taken */
+        std::uint64_t reregistered;
+
+        Stats()
+            : registered(0), renamedBeforeProbing(0), collisions(0), reregistered(0)
+        { }
+    };
+
+    MDNSCollisionResolver(MDNSManager &manager, const Options &options = Options());
+
+    ~MDNSCollisionResolver();
+
+    void setAlternativeServiceNameHandler(const MDNSManager::AlternativeServiceNameHandler &handler);
+
+    /** Start browsing type so that its instances are known before registration */
+    void watchType(const std::string &type, const std::string &domain = std::string());
+
+    /**
+     * Set a free name on service and register a copy of it. The service is
+     * only accessed during the call, on the calling thread; its address
+     * identifies the registration in unregisterService(). Renames after
+     * collisions change the copy only and are reported to the alternative
+     * service name handler.
+     *
+     * registerService() and unregisterService() may be called from any
+     * thread, but not from within a callback of the manager.
+     */
+    void registerService(MDNSService &service);
+
+    /** Unregister the copy registered for service */
+    void unregisterService(MDNSService &service);
+
+    /** Name registerService would choose now, without reserving it */
+    std::string pickName(const std::string &name, const std::string &type, const std::string &domain = std::string()) const;
+
+    const MDNSNameRegistry::Ptr & getRegistry() const { return registry_; }
+
+    Stats getStats() const;
+
+private:
+
+    struct Registration
+    {
+        std::string requestedName;
+        /** Current name, changed on collisions */
+        std::string name;
+        std::string type;
+        std::string domain;
+        /** Copy registered with the manager, owned by the resolver */
+        std::shared_ptr<MDNSService> registered;
+    };
+
+    void onAlternativeServiceName(const std::string &newName, const std::string &oldName);
+    void reregisterPending();
+
+    MDNSManager &manager_;
+    Options options_;
+    MDNSNameRegistry::Ptr registry_;
+
+    /** Serializes re-registrations with unregisterService, guards the registered copies */
+    std::mutex reregisterMutex_;
+
+    mutable std::mutex mutex_;
+    std::set<std::pair<std::string, std::string> > watched_;
+    std::map<MDNSService *, Registration> registrations_;
+    /** Services to register again under the name of their registration */
+    std::set<MDNSService *> pendingReregistrations_;
+    MDNSManager::AlternativeServiceNameHandler alternativeServiceNameHandler_;
+    Stats stats_;
+
+    /** Last member, its thread is joined before the state above is destroyed */
+    MDNSDeadlineTimer reregisterTimer_;
+};
+
+} // namespace MDNS
+
+#endif /* MDNSCOLLISIONRESOLVER_HPP_INCLUDED */
@@ -0,0 +1,829 @@
+/*
+ * MDNSCoroutines.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef MDNSCOROUTINES_HPP_INCLUDED
+#define MDNSCOROUTINES_HPP_INCLUDED
+
+#if !defined(__cpp_impl_coroutine) || __cplusplus < 202002L
+#error "MDNSCoroutines.hpp requires C++20 coroutine support"
+#endif
+
+#include "MDNSHostId.hpp"
+#include "MDNSManager.hpp"
+#include "MDNSStringRef.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Optional coroutine layer on top of MDNSManager.
+ *
+ * Coroutines run on an MDNSEventLoop, which syncWait() drives on the calling
+ * thread. MDNSManager exposes neither its loop nor timers, so its callbacks,
+ * cancellation and expired deadlines only post resumptions to the event loop.
+ * Coroutines are never resumed inside a callback of the manager, and calls
+ * into the manager from coroutines never re-enter it. No thread is started
+ * besides the one of the manager.
+ */
+
+namespace MDNS
+{
+
+/**
+ * Lazily started coroutine returning T. A task is started by co_await-ing it,
+ * or by detach() for top-level tasks.
+ */
+template <class T>
+class MDNSTask;
+
+namespace Detail
+{
+
+template <class Promise>
+struct TaskFinalAwaiter
+{
+    bool await_ready() const noexcept { return false; }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+    {
+        Promise &promise = handle.promise();
+        if (promise.continuation)
+            return promise.continuation;
+        if (promise.detached)
+            handle.destroy();
+        return std::noop_coroutine();
+    }
+
+    void await_resume() const noexcept { }
+};
+
+struct TaskPromiseBase
+{
+    std::coroutine_handle<> continuation;
+    std::exception_ptr error;
+    bool detached = false;
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+
+    void unhandled_exception() noexcept
+    {
+        error = std::current_exception();
+    }
+};
+
+template <class T>
+struct TaskPromise: public TaskPromiseBase
+{
+    std::optional<T> value;
+
+    MDNSTask<T> get_return_object() noexcept;
+
+    TaskFinalAwaiter<TaskPromise> final_suspend() const noexcept { return {}; }
+
+    template <class U>
+    void return_value(U &&v)
+    {
+        value.emplace(std::forward<U>(v));
+    }
+
+    T result()
+    {
+        if (error)
+            std::rethrow_exception(error);
+        return std::move(*value);
+    }
+};
+
+template <>
+struct TaskPromise<void>: public TaskPromiseBase
+{
+    MDNSTask<void> get_return_object() noexcept;
+
+    TaskFinalAwaiter<TaskPromise> final_suspend() const noexcept { return {}; }
+
+    void return_void() const noexcept { }
+
+    void result()
+    {
+        if (error)
+            std::rethrow_exception(error);
+    }
+};
+
+} // namespace Detail
+
+template <class T>
+class MDNSTask
+{
+public:
+
+    typedef Detail::TaskPromise<T> promise_type;
+    typedef std::coroutine_handle<promise_type> Handle;
+
+    explicit MDNSTask(Handle handle = Handle())
+        : handle_(handle)
+    { }
+
+    MDNSTask(MDNSTask &&other) noexcept
+        : handle_(std::exchange(other.handle_, Handle()))
+    { }
+
+    MDNSTask & operator=(MDNSTask &&other) noexcept
+    {
+        if (this != &other)
+        {
+            if (handle_)
+                handle_.destroy();
+            handle_ = std::exchange(other.handle_, Handle());
+        }
+        return *this;
+    }
+
+    MDNSTask(const MDNSTask &) = delete;
+    MDNSTask & operator=(const MDNSTask &) = delete;
+
+    ~MDNSTask()
+    {
+        if (handle_)
+            handle_.destroy();
+    }
+
+    bool await_ready() const noexcept { return !handle_ || handle_.done(); }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+    {
+        handle_.promise().continuation = awaiting;
+        return handle_;
+    }
+
+    T await_resume()
+    {
+        return handle_.promise().result();
+    }
+
+    /**
+     * Start the task without awaiting it, the coroutine frame is destroyed when
+     * the task completes. Exceptions of detached tasks are dropped.
+     */
+    void detach()
+    {
+        Handle handle = std::exchange(handle_, Handle());
+        if (!handle)
+            return;
+        handle.promise().detached = true;
+        handle.resume();
+    }
+
+private:
+    Handle handle_;
+};
+
+namespace Detail
+{
+
+template <class T>
+inline MDNSTask<T> TaskPromise<T>::get_return_object() noexcept
+{
+    return MDNSTask<T>(std::coroutine_handle<TaskPromise<T> >::from_promise(*this));
+}
+
+inline MDNSTask<void> TaskPromise<void>::get_return_object() noexcept
+{
+    return MDNSTask<void>(std::coroutine_handle<TaskPromise<void> >::from_promise(*this));
+}
+
+} // namespace Detail
+
+/**
+ * Queue of resumptions and timers, run by syncWait() on the thread that
+ * waits for a task. post() and the timer functions may be called from any
+ * thread, e.g. from the callbacks of MDNSManager.
+ */
+class MDNSEventLoop
+{
+public:
+
+    typedef std::chrono::steady_clock Clock;
+    typedef std::uint64_t TimerId;
+
+    explicit MDNSEventLoop(MDNSManager &manager)
+        : manager_(manager)
+    { }
+
+    MDNSEventLoop(const MDNSEventLoop &) = delete;
+    MDNSEventLoop & operator=(const MDNSEventLoop &) = delete;
+
+    MDNSManager & getManager() const { return manager_; }
+
+    void post(std::function<void ()> callback)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ready_.push_back(std::move(callback));
+        }
+        wakeup_.notify_one();
+    }
+
+    /** Resume handle on the loop */
+    void post(std::coroutine_handle<> handle)
+    {
+        post([handle]() { handle.resume(); });
+    }
+
+    TimerId schedule(Clock::time_point when, std::function<void ()> callback)
+    {
+        TimerId id;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            id = ++lastId_;
+            timers_.insert(std::make_pair(when, Timer{id, std::move(callback)}));
+        }
+        wakeup_.notify_one();
+        return id;
+    }
+
+    void cancel(TimerId id)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto it = timers_.begin(); it != timers_.end(); ++it)
+        {
+            if (it->second.id == id)
+            {
+                timers_.erase(it);
+                return;
+            }
+        }
+    }
+
+    /**
+     * Run posted callbacks and expired timers on the calling thread until
+     * done() returns true. done() is evaluated on the calling thread after
+     * every batch.
+     */
+    template <class Predicate>
+    void run(Predicate done)
+    {
+        std::vector<std::function<void ()> > batch;
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!done())
+        {
+            const Clock::time_point now = Clock::now();
+            while (!timers_.empty() && timers_.begin()->first <= now)
+            {
+                ready_.push_back(std::move(timers_.begin()->second.callback));
+                timers_.erase(timers_.begin());
+            }
+            if (!ready_.empty())
+            {
+                batch.assign(std::make_move_iterator(ready_.begin()), std::make_move_iterator(ready_.end()));
+                ready_.clear();
+                lock.unlock();
+                for (auto &callback : batch)
+                    callback();
+                batch.clear();
+                lock.lock();
+                continue;
+            }
+            if (timers_.empty())
+                wakeup_.wait(lock);
+            else
+            {
+                // Copy, the timer may be cancelled while waiting
+                const Clock::time_point next = timers_.begin()->first;
+                wakeup_.wait_until(lock, next);
+            }
+        }
+    }
+
+private:
+
+    struct Timer
+    {
+        TimerId id;
+        std::function<void ()> callback;
+    };
+
+    MDNSManager &manager_;
+    std::mutex mutex_;
+    std::condition_variable wakeup_;
+    std::deque<std::function<void ()> > ready_;
+    std::multimap<Clock::time_point, Timer> timers_;
+    TimerId lastId_ = 0;
+};
+
+/**
+ * Run the event loop on the calling thread until the task has completed,
+ * intended for main() and tests. Must not be called from a coroutine or a
+ * callback of the manager.
+ */
+template <class T>
+T syncWait(MDNSEventLoop &loop, MDNSTask<T> task)
+{
+    std::promise<T> promise;
+    std::future<T> future = promise.get_future();
+    bool done = false;
+    auto runner = [](MDNSTask<T> task, std::promise<T> &promise, bool &done) -> MDNSTask<void>
+    {
+        try
+        {
+            if constexpr (std::is_void<T>::value)
+            {
+                co_await task;
+                promise.set_value();
+            }
+            else
+                promise.set_value(co_await task);
+        }
+        catch (...)
+        {
+            promise.set_exception(std::current_exception());
+        }
+        done = true;
+    };
+    std::shared_ptr<MDNSTask<void> > started =
+        std::make_shared<MDNSTask<void> >(runner(std::move(task), promise, done));
+    loop.post([started]() { started->detach(); });
+    loop.run([&done]() { return done; });
+    return future.get();
+}
+
+/**
+ * Cooperative cancellation: callbacks registered on a token are invoked once
+ * when the source is cancelled.
+ */
+class MDNSCancellationToken
+{
+public:
+
+    MDNSCancellationToken() = default;
+
+    bool isCancelled() const
+    {
+        return state_ && state_->cancelled.load();
+    }
+
+    bool canBeCancelled() const
+    {
+        return static_cast<bool>(state_);
+    }
+
+    /**
+     * Invoke callback on cancellation, immediately if the token is already
+     * cancelled. Returns registration id for unregisterCallback().
+     */
+    std::uint64_t registerCallback(std::function<void ()> callback) const
+    {
+        if (!state_)
+            return 0;
+        {
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            if (!state_->cancelled)
+            {
+                const std::uint64_t id = ++state_->lastId;
+                state_->callbacks[id] = std::move(callback);
+                return id;
+            }
+        }
+        callback();
+        return 0;
+    }
+
+    void unregisterCallback(std::uint64_t id) const
+    {
+        if (!state_ || !id)
+            return;
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        state_->callbacks.erase(id);
+    }
+
+private:
+
+    struct State
+    {
+        std::mutex mutex;
+        std::atomic<bool> cancelled{false};
+        std::uint64_t lastId = 0;
+        std::map<std::uint64_t, std::function<void ()> > callbacks;
+    };
+
+    explicit MDNSCancellationToken(const std::shared_ptr<State> &state)
+        : state_(state)
+    { }
+
+    std::shared_ptr<State> state_;
+
+    friend class MDNSCancellationSource;
+};
+
+class MDNSCancellationSource
+{
+public:
+
+    MDNSCancellationSource()
+        : state_(std::make_shared<MDNSCancellationToken::State>())
+    { }
+
+    MDNSCancellationToken getToken() const
+    {
+        return MDNSCancellationToken(state_);
+    }
+
+    void cancel()
+    {
+        std::map<std::uint64_t, std::function<void ()> > callbacks;
+        {
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            if (state_->cancelled.exchange(true))
+                return;
+            callbacks.swap(state_->callbacks);
+        }
+        for (auto &callback : callbacks)
+            callback.second();
+    }
+
+private:
+    std::shared_ptr<MDNSCancellationToken::State> state_;
+};
+
+struct MDNSBrowseEvent
+{
+    enum Kind
+    {
+        NEW_SERVICE,
+        REMOVED_SERVICE
+    };
+
+    Kind kind;
+    /** For REMOVED_SERVICE only name, type, domain and interface index are set */
+    MDNSService service;
+};
+
+/**
+ * Browse results as an asynchronous stream:
+ *
+ *   auto stream = MDNSBrowseStream::create(loop, MDNS_IF_ANY, "_http._tcp");
+ *   while (auto event = co_await stream->next(std::chrono::seconds(5)))
+ *       ...
+ *
+ * next() yields std::nullopt when the stream is closed, cancelled or the
+ * timeout expired (see isClosed()). Streams must be created, awaited and
+ * closed on the event loop, which must outlive them.
+ */
+class MDNSBrowseStream: public MDNSServiceBrowser,
+                        public std::enable_shared_from_this<MDNSBrowseStream>
+{
+public:
+
+    typedef std::shared_ptr<MDNSBrowseStream> Ptr;
+    typedef std::chrono::steady_clock Clock;
+
+    static Ptr create(MDNSEventLoop &loop,
+                      MDNSInterfaceIndex interfaceIndex,
+                      const std::string &type,
+                      const std::vector<std::string> &subtypes = std::vector<std::string>(),
+                      const std::string &domain = std::string(),
+                      const MDNSCancellationToken &token = MDNSCancellationToken())
+    {
+        Ptr stream(new MDNSBrowseStream(loop));
+        std::weak_ptr<MDNSBrowseStream> weakStream(stream);
+        // Cancellation may come from any thread, close on the loop
+        stream->cancelRegistration_ = token.registerCallback([&loop, weakStream]()
+        {
+            loop.post([weakStream]()
+            {
+                if (Ptr s = weakStream.lock())
+                    s->close();
+            });
+        });
+        if (!token.isCancelled())
+        {
+            stream->registered_ = true;
+            MDNSManager &manager = loop.getManager();
+            if (subtypes.empty())
+                manager.registerServiceBrowser(stream, interfaceIndex, type, domain);
+            else
+                manager.registerServiceBrowser(stream, interfaceIndex, type, subtypes, domain);
+        }
+        else
+            stream->closed_ = true;
+        stream->token_ = token;
+        return stream;
+    }
+
+    ~MDNSBrowseStream() override
+    {
+        token_.unregisterCallback(cancelRegistration_);
+    }
+
+    class NextAwaiter
+    {
+    public:
+
+        NextAwaiter(MDNSBrowseStream &stream, Clock::duration timeout)
+            : stream_(stream), timeout_(timeout)
+        { }
+
+        bool await_ready()
+        {
+            std::lock_guard<std::mutex> lock(stream_.mutex_);
+            return !stream_.events_.empty() || stream_.closed_;
+        }
+
+        bool await_suspend(std::coroutine_handle<> handle)
+        {
+            Ptr self = stream_.shared_from_this();
+            std::lock_guard<std::mutex> lock(stream_.mutex_);
+            if (!stream_.events_.empty() || stream_.closed_)
+                return false;
+            stream_.waiter_ = handle;
+            const std::uint64_t waitId = ++stream_.waitId_;
+            if (timeout_ != Clock::duration::max())
+            {
+                std::weak_ptr<MDNSBrowseStream> weakStream(self);
+                stream_.timerId_ = stream_.loop_.schedule(Clock::now() + timeout_, [weakStream, waitId]()
+                {
+                    if (Ptr s = weakStream.lock())
+                        s->expire(waitId);
+                });
+            }
+            return true;
+        }
+
+        std::optional<MDNSBrowseEvent> await_resume()
+        {
+            std::lock_guard<std::mutex> lock(stream_.mutex_);
+            if (stream_.events_.empty())
+                return std::nullopt;
+            MDNSBrowseEvent event = std::move(stream_.events_.front());
+            stream_.events_.pop_front();
+            return event;
+        }
+
+    private:
+        MDNSBrowseStream &stream_;
+        Clock::duration timeout_;
+    };
+
+    NextAwaiter next(Clock::duration timeout = Clock::duration::max())
+    {
+        return NextAwaiter(*this, timeout);
+    }
+
+    /**
+     * Stop browsing and wake up the waiting coroutine. Pending events can
+     * still be consumed. Must be called on the loop.
+     */
+    void close()
+    {
+        std::coroutine_handle<> waiter;
+        bool unregister = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (closed_)
+                return;
+            closed_ = true;
+            unregister = registered_;
+            waiter = takeWaiter();
+        }
+        if (unregister)
+            loop_.getManager().unregisterServiceBrowser(shared_from_this());
+        if (waiter)
+            loop_.post(waiter);
+    }
+
+    bool isClosed() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return closed_;
+    }
+
+    void onNewService(const MDNSService &service) override
+    {
+        MDNSBrowseEvent event;
+        event.kind = MDNSBrowseEvent::NEW_SERVICE;
+        event.service = service;
+        push(std::move(event));
+    }
+
+    void onRemovedService(const std::string &name, const std::string &type, const std::string &domain, MDNSInterfaceIndex interfaceIndex) override
+    {
+        MDNSBrowseEvent event;
+        event.kind = MDNSBrowseEvent::REMOVED_SERVICE;
+        event.service.setName(name).setType(type).setDomain(domain).setInterfaceIndex(interfaceIndex);
+        push(std::move(event));
+    }
+
+private:
+
+    explicit MDNSBrowseStream(MDNSEventLoop &loop)
+        : loop_(loop)
+    { }
+
+    std::coroutine_handle<> takeWaiter()
+    {
+        if (timerId_)
+        {
+            loop_.cancel(timerId_);
+            timerId_ = 0;
+        }
+        return std::exchange(waiter_, std::coroutine_handle<>());
+    }
+
+    /** Called on the thread of the manager, the waiter is resumed on the loop */
+    void push(MDNSBrowseEvent &&event)
+    {
+        std::coroutine_handle<> waiter;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (closed_)
+                return;
+            events_.push_back(std::move(event));
+            waiter = takeWaiter();
+        }
+        if (waiter)
+            loop_.post(waiter);
+    }
+
+    void expire(std::uint64_t waitId)
+    {
+        std::coroutine_handle<> waiter;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (waitId != waitId_ || !waiter_)
+                return;
+            timerId_ = 0;
+            waiter = std::exchange(waiter_, std::coroutine_handle<>());
+        }
+        waiter.resume();
+    }
+
+    MDNSEventLoop &loop_;
+    MDNSCancellationToken token_;
+    std::uint64_t cancelRegistration_ = 0;
+
+    mutable std::mutex mutex_;
+    std::deque<MDNSBrowseEvent> events_;
+    std::coroutine_handle<> waiter_;
+    std::uint64_t waitId_ = 0;
+    MDNSEventLoop::TimerId timerId_ = 0;
+    bool registered_ = false;
+    bool closed_ = false;
+};
+
+/**
+ * Browse for services of the given type and return the first maxCount
+ * resolved services, or fewer if the timeout expired or the token was
+ * cancelled.
+ */
+inline MDNSTask<std::vector<MDNSService> > resolveServices(MDNSEventLoop &loop,
+                                                          MDNSInterfaceIndex interfaceIndex,
+                                                          std::string type,
+                                                          std::vector<std::string> subtypes,
+                                                          std::size_t maxCount,
+                                                          std::chrono::steady_clock::duration timeout,
+                                                          MDNSCancellationToken token = MDNSCancellationToken())
+{
+    std::vector<MDNSService> result;
+    MDNSBrowseStream::Ptr stream = MDNSBrowseStream::create(loop, interfaceIndex, type, subtypes, std::string(), token);
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+    while (result.size() < maxCount)
+    {
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= deadline)
+            break;
+        std::optional<MDNSBrowseEvent> event = co_await stream->next(deadline - now);
+        if (!event)
+            break;
+        if (event->kind == MDNSBrowseEvent::NEW_SERVICE)
+            result.push_back(std::move(event->service));
+    }
+    stream->close();
+    co_return result;
+}
+
+namespace Detail
+{
+
+inline bool isDecimal(const MDNSStringRef &str)
+{
+    for (const char *c = str.begin(); c != str.end(); ++c)
+    {
+        if (*c < '0' || *c > '9')
+            return false;
+    }
+    return !str.empty();
+}
+
+/** Name equals requested, or is an alternative name like "Name #2" (Avahi) or "Name (2)" (Bonjour) */
+inline bool isServiceNameOrAlternative(const std::string &name, const std::string &requested)
+{
+    if (name.size() < requested.size() || name.compare(0, requested.size(), requested) != 0)
+        return false;
+    MDNSStringRef suffix = MDNSStringRef(name).substr(requested.size());
+    if (suffix.empty())
+        return true;
+    if (suffix.size() > 2 && suffix[0] == ' ' && suffix[1] == '#')
+        suffix = suffix.substr(2);
+    else if (suffix.size() > 3 && suffix[0] == ' ' && suffix[1] == '(' && suffix[suffix.size() - 1] == ')')
+        suffix = suffix.substr(2, suffix.size() - 3);
+    else
+        return false;
+    return isDecimal(suffix);
+}
+
+/** Host label equals requested, or is an alternative name like "host-2" (Avahi) */
+inline bool isHostOrAlternative(const MDNSStringRef &label, const MDNSStringRef &requested)
+{
+    if (label.size() < requested.size() || !label.substr(0, requested.size()).equalsIgnoreCase(requested))
+        return false;
+    const MDNSStringRef suffix = label.substr(requested.size());
+    return suffix.empty() || (suffix[0] == '-' && isDecimal(suffix.substr(1)));
+}
+
+/** Domain and host names compare case-insensitively, an empty domain is "local" */
+inline bool equalDomains(const std::string &a, const std::string &b)
+{
+    return MDNSStringRef(a.empty() ? "local" : a).equalsIgnoreCase(MDNSStringRef(b.empty() ? "local" : b));
+}
+
+/** First label of host name, "myhost.local." -> "myhost" */
+inline MDNSStringRef hostLabel(const std::string &host)
+{
+    const MDNSStringRef ref(host);
+    return ref.substr(0, ref.find('.'));
+}
+
+/**
+ * Whether found is the registered service: same type, domain, port, TXT
+ * records and interface (unless registered on all interfaces), the name or
+ * an alternative name chosen by the daemon, and the requested host or, for
+ * services registered without host, the local host (or its alternative).
+ */
+inline bool isRegisteredService(const MDNSService &found, const MDNSService &service, const std::string &localHost)
+{
+    if (!MDNSStringRef(found.getType()).equalsIgnoreCase(service.getType()) ||
+        !equalDomains(found.getDomain(), service.getDomain()) ||
+        found.getPort() != service.getPort() ||
+        found.getTxtRecords() != service.getTxtRecords() ||
+        (service.getInterfaceIndex() != MDNS_IF_ANY && found.getInterfaceIndex() != service.getInterfaceIndex()) ||
+        !isServiceNameOrAlternative(found.getName(), service.getName()))
+        return false;
+    const std::string &host = service.getHost().empty() ? localHost : service.getHost();
+    return host.empty() || isHostOrAlternative(hostLabel(found.getHost()), hostLabel(host));
+}
+
+} // namespace Detail
+
+/**
+ * Register service and complete when the service is announced, i.e. when a
+ * browser for its type sees it. Returns false on timeout or cancellation,
+ * the service stays registered in that case.
+ */
+inline MDNSTask<bool> registerServiceAsync(MDNSEventLoop &loop,
+                                           MDNSService &service,
+                                           std::chrono::steady_clock::duration timeout,
+                                           MDNSCancellationToken token = MDNSCancellationToken())
+{
+    MDNSBrowseStream::Ptr stream = MDNSBrowseStream::create(loop, service.getInterfaceIndex(),
+                                                            service.getType(), std::vector<std::string>(),
+                                                            service.getDomain(), token);
+    loop.getManager().registerService(service);
+
+    const std::string localHost = getDefaultHostId();
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    bool announced = false;
+    while (!announced)
+    {
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= deadline)
+            break;
+        std::optional<MDNSBrowseEvent> event = co_await stream->next(deadline - now);
+        if (!event)
+            break;
+        announced = event->kind == MDNSBrowseEvent::NEW_SERVICE &&
+            Detail::isRegisteredService(event->service, service, localHost);
+    }
+    stream->close();
+    co_return announced;
+}
+
+} // namespace MDNS
+
+#endif /* MDNSCOROUTINES_HPP_INCLUDED */
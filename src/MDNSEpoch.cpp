@@ -0,0 +1,226 @@
+/*
+ * MDNSEpoch.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include "MDNSEpoch.hpp"
+#include <mutex>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace MDNS
+{
+
+namespace
+{
+
+std::atomic<std::uint64_t> nextDomainId(1);
+
+// Ids of live domains, consulted by exiting threads before they release slots
+std::mutex & getRegistryMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::unordered_set<std::uint64_t> & getLiveDomains()
+{
+    static std::unordered_set<std::uint64_t> domains;
+    return domains;
+}
+
+} // namespace
+
+/**
+ * Reader slots of the current thread, released on thread exit.
+ */
+struct ThreadSlots
+{
+    struct Registration
+    {
+        std::uint64_t domainId;
+        MDNSEpochDomain *domain;
+        std::size_t index;
+    };
+
+    std::vector<Registration> registrations;
+
+    ~ThreadSlots()
+    {
+        std::lock_guard<std::mutex> lock(getRegistryMutex());
+        for (auto it = registrations.begin(), iend = registrations.end(); it != iend; ++it)
+        {
+            if (getLiveDomains().count(it->domainId))
+                it->domain->releaseSlot(it->index);
+        }
+    }
+};
+
+static thread_local ThreadSlots threadSlots;
+
+MDNSEpochDomain::MDNSEpochDomain()
+    : id_(nextDomainId++)
+    , epoch_(0)
+{
+    for (std::size_t i = 0; i < MAX_READERS; ++i)
+    {
+        slots_[i].epoch.store(IDLE, std::memory_order_relaxed);
+        slots_[i].used.store(false, std::memory_order_relaxed);
+    }
+    std::lock_guard<std::mutex> lock(getRegistryMutex());
+    getLiveDomains().insert(id_);
+}
+
+MDNSEpochDomain::~MDNSEpochDomain()
+{
+    {
+        std::lock_guard<std::mutex> lock(getRegistryMutex());
+        getLiveDomains().erase(id_);
+    }
+    // No readers may exist anymore
+    for (auto it = retired_.begin(), iend = retired_.end(); it != iend; ++it)
+        it->second();
+}
+
+std::atomic<std::uint64_t> & MDNSEpochDomain::getReaderSlot()
+{
+    std::vector<ThreadSlots::Registration> &registrations = threadSlots.registrations;
+    for (auto it = registrations.begin(), iend = registrations.end(); it != iend; ++it)
+    {
+        if (it->domainId == id_)
+            return slots_[it->index].epoch;
+    }
+    return acquireSlot();
+}
+
+std::atomic<std::uint64_t> & MDNSEpochDomain::acquireSlot()
+{
+    std::vector<ThreadSlots::Registration> &registrations = threadSlots.registrations;
+    {
+        // Forget registrations of destroyed domains
+        std::lock_guard<std::mutex> lock(getRegistryMutex());
+        for (auto it = registrations.begin(); it != registrations.end(); )
+        {
+            if (getLiveDomains().count(it->domainId))
+                ++it;
+            else
+                it = registrations.erase(it);
+        }
+    }
+
+    for (std::size_t i = 0; i < MAX_READERS; ++i)
+    {
+        bool expected = false;
+        if (!slots_[i].used.load(std::memory_order_relaxed) &&
+            slots_[i].used.compare_exchange_strong(expected, true))
+        {
+            ThreadSlots::Registration registration = { id_, this, i };
+            registrations.push_back(registration);
+            return slots_[i].epoch;
+        }
+    }
+    throw std::runtime_error("MDNSEpochDomain: too many concurrent reader threads");
+}
+
+void MDNSEpochDomain::releaseSlot(std::size_t index)
+{
+    slots_[index].epoch.store(IDLE, std::memory_order_release);
+    slots_[index].used.store(false, std::memory_order_release);
+}
+
+void MDNSEpochDomain::retire(std::function<void ()> deleter)
+{
+    const std::uint64_t epoch = epoch_.fetch_add(1, std::memory_order_seq_cst);
+    retired_.push_back(std::make_pair(epoch, std::move(deleter)));
+}
+
+std::size_t MDNSEpochDomain::reclaim()
+{
+    if (retired_.empty())
+        return 0;
+
+    std::uint64_t minEpoch = IDLE;
+    for (std::size_t i = 0; i < MAX_READERS; ++i)
+    {
+        const std::uint64_t epoch = slots_[i].epoch.load(std::memory_order_seq_cst);
+        if (epoch < minEpoch)
+            minEpoch = epoch;
+    }
+
+    // Readers in epoch e may still reference objects retired in epoch e
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < retired_.size(); ++i)
+    {
+        if (retired_[i].first < minEpoch)
+            retired_[i].second();
+        else if (kept++ != i)
+            retired_[kept - 1] = std::move(retired_[i]);
+    }
+    retired_.resize(kept);
+    return kept;
+}
+
+// MDNSDeadlineTimer
+
+MDNSDeadlineTimer::MDNSDeadlineTimer(const std::function<void ()> &callback)
+    : callback_(callback)
+    , deadline_(Clock::time_point::max())
+    , stopping_(false)
+{
+}
+
+MDNSDeadlineTimer::~MDNSDeadlineTimer()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wakeup_.notify_all();
+    if (thread_.joinable())
+        thread_.join();
+}
+
+void MDNSDeadlineTimer::arm(Clock::time_point deadline)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (deadline >= deadline_)
+            return;
+        deadline_ = deadline;
+        if (!thread_.joinable())
+            thread_ = std::thread(&MDNSDeadlineTimer::run, this);
+    }
+    wakeup_.notify_all();
+}
+
+void MDNSDeadlineTimer::disarm()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    deadline_ = Clock::time_point::max();
+}
+
+void MDNSDeadlineTimer::run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_)
+    {
+        if (deadline_ == Clock::time_point::max())
+        {
+            wakeup_.wait(lock);
+            continue;
+        }
+        const Clock::time_point deadline = deadline_;
+        if (Clock::now() < deadline)
+        {
+            wakeup_.wait_until(lock, deadline);
+            continue;
+        }
+        deadline_ = Clock::time_point::max();
+        lock.unlock();
+        callback_();
+        lock.lock();
+    }
+}
+
+} // namespace MDNS
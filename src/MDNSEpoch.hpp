@@ -0,0 +1,197 @@
+/*
+ * MDNSEpoch.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef MDNSEPOCH_HPP_INCLUDED
+#define MDNSEPOCH_HPP_INCLUDED
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace MDNS
+{
+
+/**
+ * Epoch based reclamation for data structures with a single writer and many
+ * readers.
+ *
+ * Readers enter a critical section by publishing the current global epoch in
+ * their own cache line sized slot, which is wait-free. Only the first guard
+ * of a thread acquires its slot, under a global mutex. The writer retires
+ * replaced objects with the epoch of their retirement and frees them once
+ * every active reader has entered a later epoch.
+ */
+class MDNSEpochDomain
+{
+public:
+
+    /** Maximal number of threads that read concurrently from one domain */
+    static const std::size_t MAX_READERS = 256;
+
+    MDNSEpochDomain();
+    ~MDNSEpochDomain();
+
+    MDNSEpochDomain(const MDNSEpochDomain &) = delete;
+    MDNSEpochDomain & operator=(const MDNSEpochDomain &) = delete;
+
+    /**
+     * RAII reader critical section. Pointers loaded while the guard exists stay
+     * valid until it is destroyed. Guards of the same domain must not be nested.
+     */
+    class ReadGuard
+    {
+    public:
+
+        explicit ReadGuard(MDNSEpochDomain &domain)
+            : epoch_(domain.getReaderSlot())
+        {
+            epoch_.store(domain.epoch_.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+        }
+
+        ~ReadGuard()
+        {
+            epoch_.store(IDLE, std::memory_order_release);
+        }
+
+        ReadGuard(const ReadGuard &) = delete;
+        ReadGuard & operator=(const ReadGuard &) = delete;
+
+    private:
+        std::atomic<std::uint64_t> &epoch_;
+    };
+
+    /**
+     * Retire an object that is no longer reachable for new readers.
+     * Must be called by the writer only.
+     */
+    void retire(std::function<void ()> deleter);
+
+    /**
+     * Free all retired objects that are no longer visible to any reader.
+     * Must be called by the writer only. Returns number of objects that are
+     * still pending.
+     */
+    std::size_t reclaim();
+
+    std::size_t getPendingCount() const { return retired_.size(); }
+
+private:
+
+    static const std::uint64_t IDLE = ~std::uint64_t(0);
+
+    struct alignas(64) Slot
+    {
+        std::atomic<std::uint64_t> epoch;
+        std::atomic<bool> used;
+    };
+
+    std::atomic<std::uint64_t> & getReaderSlot();
+    std::atomic<std::uint64_t> & acquireSlot();
+    void releaseSlot(std::size_t index);
+
+    const std::uint64_t id_;
+    std::atomic<std::uint64_t> epoch_;
+    Slot slots_[MAX_READERS];
+    std::vector<std::pair<std::uint64_t, std::function<void ()> > > retired_;
+
+    friend struct ThreadSlots;
+};
+
+/**
+ * Atomically published pointer to immutable versions of T. Readers access the
+ * current version wait-free (see MDNSEpochDomain), the writer publishes new ones.
+ */
+template <class T>
+class MDNSPublished
+{
+public:
+
+    MDNSPublished(MDNSEpochDomain &domain, T *initial)
+        : domain_(domain), current_(initial)
+    { }
+
+    ~MDNSPublished()
+    {
+        domain_.reclaim();
+        delete current_.load();
+    }
+
+    MDNSPublished(const MDNSPublished &) = delete;
+    MDNSPublished & operator=(const MDNSPublished &) = delete;
+
+    /**
+     * Returns current version, valid as long as the guard exists.
+     */
+    const T * load(const MDNSEpochDomain::ReadGuard &) const
+    {
+        return current_.load(std::memory_order_seq_cst);
+    }
+
+    /** Writer side access to the current version */
+    const T * get() const
+    {
+        return current_.load(std::memory_order_relaxed);
+    }
+
+    /** Replace current version, the old one is freed when no reader uses it */
+    void publish(T *version)
+    {
+        T *old = current_.exchange(version, std::memory_order_seq_cst);
+        domain_.retire([old]() { delete old; });
+        domain_.reclaim();
+    }
+
+private:
+    MDNSEpochDomain &domain_;
+    std::atomic<T *> current_;
+};
+
+/**
+ * Calls back once the earliest armed deadline has expired, so that writers
+ * which batch changes publish the last batch without waiting for another
+ * change. The thread is started on the first arm() and joined by the
+ * destructor, the callback runs on it without any lock of the timer held.
+ */
+class MDNSDeadlineTimer
+{
+public:
+
+    typedef std::chrono::steady_clock Clock;
+
+    explicit MDNSDeadlineTimer(const std::function<void ()> &callback);
+
+    ~MDNSDeadlineTimer();
+
+    MDNSDeadlineTimer(const MDNSDeadlineTimer &) = delete;
+    MDNSDeadlineTimer & operator=(const MDNSDeadlineTimer &) = delete;
+
+    /** Call back at deadline, unless an earlier deadline is already armed */
+    void arm(Clock::time_point deadline);
+
+    void disarm();
+
+private:
+
+    void run();
+
+    const std::function<void ()> callback_;
+    std::mutex mutex_;
+    std::condition_variable wakeup_;
+    Clock::time_point deadline_;
+    bool stopping_;
+    std::thread thread_;
+};
+
+} // namespace MDNS
+
+#endif /* MDNSEPOCH_HPP_INCLUDED */
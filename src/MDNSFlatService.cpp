@@ -0,0 +1,268 @@
+/*
+ * MDNSFlatService.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include "MDNSFlatService.hpp"
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <tuple>
+
+namespace MDNS
+{
+
+namespace
+{
+
+const std::size_t ALIGNMENT = 8;
+
+inline std::size_t alignUp(std::size_t size)
+{
+    return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+}
+
+} // namespace
+
+// MDNSServiceArena
+
+MDNSServiceArena::Ptr MDNSServiceArena::create(std::size_t chunkSize)
+{
+    return Ptr(new MDNSServiceArena(chunkSize));
+}
+
+MDNSServiceArena::MDNSServiceArena(std::size_t chunkSize)
+    : refs_(1)
+    , chunkSize_(chunkSize)
+    , current_(0)
+    , end_(0)
+    , used_(0)
+{
+}
+
+MDNSServiceArena::~MDNSServiceArena()
+{
+    for (auto it = chunks_.begin(), iend = chunks_.end(); it != iend; ++it)
+        ::operator delete(*it);
+}
+
+void * MDNSServiceArena::allocate(std::size_t size)
+{
+    size = alignUp(size);
+    if (static_cast<std::size_t>(end_ - current_) < size)
+    {
+        const std::size_t chunkSize = std::max(chunkSize_, size);
+        current_ = static_cast<char *>(::operator new(chunkSize));
+        end_ = current_ + chunkSize;
+        chunks_.push_back(current_);
+    }
+    void *result = current_;
+    current_ += size;
+    used_ += size;
+    return result;
+}
+
+// MDNSFlatService
+
+std::size_t MDNSFlatService::computeSize(const MDNSService &service)
+{
+    const std::vector<std::string> &subtypes = service.getSubtypes();
+    const std::vector<std::string> &txt = service.getTxtRecords();
+    std::size_t size = sizeof(Header) + (subtypes.size() + txt.size()) * sizeof(Field);
+    size += service.getName().size() + service.getType().size() + service.getDomain().size() + service.getHost().size();
+    for (auto it = subtypes.begin(), iend = subtypes.end(); it != iend; ++it)
+        size += it->size();
+    for (auto it = txt.begin(), iend = txt.end(); it != iend; ++it)
+        size += it->size();
+    return alignUp(size);
+}
+
+MDNSFlatService::Header * MDNSFlatService::construct(void *block, std::size_t size, const MDNSService &service, MDNSServiceArena *arena)
+{
+    Header *header = new (block) Header();
+    header->refs.store(1, std::memory_order_relaxed);
+    header->size = static_cast<std::uint32_t>(size);
+    header->arena = arena;
+    header->port = service.getPort();
+    header->interfaceIndex = service.getInterfaceIndex();
+
+    const std::vector<std::string> &subtypes = service.getSubtypes();
+    const std::vector<std::string> &txt = service.getTxtRecords();
+    header->subtypeCount = static_cast<std::uint32_t>(subtypes.size());
+    header->txtCount = static_cast<std::uint32_t>(txt.size());
+
+    char *base = static_cast<char *>(block);
+    Field *fields = reinterpret_cast<Field *>(header + 1);
+    std::uint32_t offset = static_cast<std::uint32_t>(sizeof(Header) + (subtypes.size() + txt.size()) * sizeof(Field));
+    auto put = [base, &offset](Field &field, const std::string &str)
+    {
+        field.offset = offset;
+        field.size = static_cast<std::uint32_t>(str.size());
+        std::memcpy(base + offset, str.data(), str.size());
+        offset += field.size;
+    };
+
+    put(header->name, service.getName());
+    put(header->type, service.getType());
+    put(header->domain, service.getDomain());
+    put(header->host, service.getHost());
+    for (std::size_t i = 0; i < subtypes.size(); ++i)
+        put(fields[i], subtypes[i]);
+    for (std::size_t i = 0; i < txt.size(); ++i)
+        put(fields[subtypes.size() + i], txt[i]);
+    return header;
+}
+
+MDNSFlatService::MDNSFlatService(const MDNSService &service)
+{
+    const std::size_t size = computeSize(service);
+    header_ = construct(::operator new(size), size, service, 0);
+}
+
+MDNSFlatService::MDNSFlatService(const MDNSService &service, MDNSServiceArena &arena)
+{
+    const std::size_t size = computeSize(service);
+    header_ = construct(arena.allocate(size), size, service, &arena);
+    arena.retain();
+}
+
+MDNSFlatService::MDNSFlatService(const MDNSFlatService &other, MDNSServiceArena &arena)
+    : header_(0)
+{
+    if (!other.header_)
+        return;
+    // Offsets are relative to the block, the data after the header is copied
+    // as bytes, the header with its atomic is constructed field by field
+    const Header &source = *other.header_;
+    void *block = arena.allocate(source.size);
+    Header *header = new (block) Header();
+    header->refs.store(1, std::memory_order_relaxed);
+    header->size = source.size;
+    header->arena = &arena;
+    header->port = source.port;
+    header->interfaceIndex = source.interfaceIndex;
+    header->name = source.name;
+    header->type = source.type;
+    header->domain = source.domain;
+    header->host = source.host;
+    header->subtypeCount = source.subtypeCount;
+    header->txtCount = source.txtCount;
+    std::memcpy(reinterpret_cast<char *>(header) + sizeof(Header), reinterpret_cast<const char *>(&source) + sizeof(Header),
+                source.size - sizeof(Header));
+    header_ = header;
+    arena.retain();
+}
+
+void MDNSFlatService::release()
+{
+    if (!header_)
+        return;
+    if (header_->arena)
+        header_->arena->release();
+    else if (header_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        header_->~Header();
+        ::operator delete(header_);
+    }
+    header_ = 0;
+}
+
+bool MDNSFlatService::findTxtValue(const MDNSStringRef &key, MDNSStringRef &value) const
+{
+    for (std::size_t i = 0, n = getTxtRecordCount(); i < n; ++i)
+    {
+        const MDNSStringRef record = getTxtRecord(i);
+        const std::size_t eq = record.find('=');
+        // RFC 6763 section 6.4: keys are case-insensitive
+        if (record.substr(0, eq).equalsIgnoreCase(key))
+        {
+            value = eq == std::string::npos ? MDNSStringRef() : record.substr(eq + 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+MDNSService MDNSFlatService::toService() const
+{
+    MDNSService service;
+    if (!header_)
+        return service;
+    service.setName(getName().str())
+        .setType(getType().str())
+        .setDomain(getDomain().str())
+        .setHost(getHost().str())
+        .setPort(getPort())
+        .setInterfaceIndex(getInterfaceIndex());
+    std::vector<std::string> strings;
+    strings.reserve(getSubtypeCount());
+    for (std::size_t i = 0, n = getSubtypeCount(); i < n; ++i)
+        strings.push_back(getSubtype(i).str());
+    service.setSubtypes(strings);
+    strings.clear();
+    for (std::size_t i = 0, n = getTxtRecordCount(); i < n; ++i)
+        strings.push_back(getTxtRecord(i).str());
+    service.setTxtRecords(strings);
+    return service;
+}
+
+// MDNSFlatServiceSet
+
+namespace
+{
+
+inline std::tuple<MDNSStringRef, MDNSStringRef, MDNSStringRef, MDNSInterfaceIndex> makeKey(const MDNSFlatService &service)
+{
+    return std::make_tuple(service.getType(), service.getName(), service.getDomain(), service.getInterfaceIndex());
+}
+
+} // namespace
+
+MDNSFlatServiceSet::MDNSFlatServiceSet(std::size_t chunkSize)
+    : arena_(MDNSServiceArena::create(chunkSize))
+{
+}
+
+void MDNSFlatServiceSet::add(const MDNSService &service)
+{
+    services_.push_back(MDNSFlatService(service, *arena_));
+}
+
+void MDNSFlatServiceSet::add(const MDNSFlatService &service)
+{
+    services_.push_back(MDNSFlatService(service, *arena_));
+}
+
+void MDNSFlatServiceSet::sort()
+{
+    auto less = [](const MDNSFlatService &a, const MDNSFlatService &b) { return makeKey(a) < makeKey(b); };
+    // Snapshots of sorted maps are usually in order already
+    if (!std::is_sorted(services_.begin(), services_.end(), less))
+        std::sort(services_.begin(), services_.end(), less);
+}
+
+const MDNSFlatService * MDNSFlatServiceSet::find(const MDNSStringRef &name, const MDNSStringRef &type,
+                                                 const MDNSStringRef &domain, MDNSInterfaceIndex interfaceIndex) const
+{
+    const auto key = std::make_tuple(type, name, domain, interfaceIndex);
+    auto it = std::lower_bound(services_.begin(), services_.end(), key,
+        [](const MDNSFlatService &service, const std::tuple<MDNSStringRef, MDNSStringRef, MDNSStringRef, MDNSInterfaceIndex> &k)
+        {
+            return makeKey(service) < k;
+        });
+    if (it == services_.end() || makeKey(*it) != key)
+        return 0;
+    return &*it;
+}
+
+std::pair<MDNSFlatServiceSet::const_iterator, MDNSFlatServiceSet::const_iterator> MDNSFlatServiceSet::findByType(const MDNSStringRef &type) const
+{
+    auto first = std::lower_bound(services_.begin(), services_.end(), type,
+        [](const MDNSFlatService &service, const MDNSStringRef &t) { return service.getType() < t; });
+    auto last = std::upper_bound(first, services_.end(), type,
+        [](const MDNSStringRef &t, const MDNSFlatService &service) { return t < service.getType(); });
+    return std::make_pair(first, last);
+}
+
+} // namespace MDNS
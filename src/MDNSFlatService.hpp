@@ -0,0 +1,264 @@
+/*
+ * MDNSFlatService.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef MDNSFLATSERVICE_HPP_INCLUDED
+#define MDNSFLATSERVICE_HPP_INCLUDED
+
+#include "MDNSManager.hpp"
+#include "MDNSStringRef.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace MDNS
+{
+
+/**
+ * Bump allocator for the records of one snapshot generation. Memory is only
+ * released all at once, when the last reference to the arena is gone.
+ * Allocation is not thread-safe, references may be taken and dropped on
+ * any thread.
+ */
+class MDNSServiceArena
+{
+public:
+
+    /** Intrusive reference to an arena */
+    class Ptr
+    {
+    public:
+        Ptr() : arena_(0) { }
+        Ptr(const Ptr &other) : arena_(other.arena_) { if (arena_) arena_->retain(); }
+        Ptr(Ptr &&other) : arena_(other.arena_) { other.arena_ = 0; }
+        ~Ptr() { if (arena_) arena_->release(); }
+
+        Ptr & operator=(Ptr other)
+        {
+            std::swap(arena_, other.arena_);
+            return *this;
+        }
+
+        MDNSServiceArena * get() const { return arena_; }
+        MDNSServiceArena & operator*() const { return *arena_; }
+        MDNSServiceArena * operator->() const { return arena_; }
+        explicit operator bool() const { return arena_ != 0; }
+
+    private:
+        explicit Ptr(MDNSServiceArena *arena) : arena_(arena) { }
+
+        MDNSServiceArena *arena_;
+
+        friend class MDNSServiceArena;
+    };
+
+    static Ptr create(std::size_t chunkSize = 64 * 1024);
+
+    MDNSServiceArena(const MDNSServiceArena &) = delete;
+    MDNSServiceArena & operator=(const MDNSServiceArena &) = delete;
+
+    /** Allocate size bytes aligned for any record header */
+    void * allocate(std::size_t size);
+
+    /** Bytes handed out by allocate() */
+    std::size_t getUsedBytes() const { return used_; }
+
+    std::size_t getChunkCount() const { return chunks_.size(); }
+
+    void retain() { refs_.fetch_add(1, std::memory_order_relaxed); }
+
+    void release()
+    {
+        if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete this;
+    }
+
+private:
+
+    explicit MDNSServiceArena(std::size_t chunkSize);
+    ~MDNSServiceArena();
+
+    std::atomic<std::size_t> refs_;
+    std::size_t chunkSize_;
+    std::vector<char *> chunks_;
+    char *current_;
+    char *end_;
+    std::size_t used_;
+};
+
+/**
+ * Compact, immutable copy of an MDNSService in one contiguous block: a
+ * header with offsets of all strings, TXT records and subtypes, followed by
+ * the characters. Copies share the block through a reference count, so
+ * copying and moving never allocate.
+ *
+ * Blocks come from the heap (one allocation per record) or from an
+ * MDNSServiceArena, where copies reference the whole arena instead.
+ */
+class MDNSFlatService
+{
+public:
+
+    MDNSFlatService()
+        : header_(0)
+    { }
+
+    /** Copy service into a single heap allocation */
+    explicit MDNSFlatService(const MDNSService &service);
+
+    /** Copy service into arena */
+    MDNSFlatService(const MDNSService &service, MDNSServiceArena &arena);
+
+    /** Copy the block of other into arena */
+    MDNSFlatService(const MDNSFlatService &other, MDNSServiceArena &arena);
+
+    MDNSFlatService(const MDNSFlatService &other)
+        : header_(other.header_)
+    {
+        retain();
+    }
+
+    MDNSFlatService(MDNSFlatService &&other)
+        : header_(other.header_)
+    {
+        other.header_ = 0;
+    }
+
+    ~MDNSFlatService()
+    {
+        release();
+    }
+
+    MDNSFlatService & operator=(MDNSFlatService other)
+    {
+        std::swap(header_, other.header_);
+        return *this;
+    }
+
+    bool isNull() const { return header_ == 0; }
+
+    MDNSStringRef getName() const { return getString(header_->name); }
+    MDNSStringRef getType() const { return getString(header_->type); }
+    MDNSStringRef getDomain() const { return getString(header_->domain); }
+    MDNSStringRef getHost() const { return getString(header_->host); }
+    unsigned int getPort() const { return header_->port; }
+    MDNSInterfaceIndex getInterfaceIndex() const { return header_->interfaceIndex; }
+
+    std::size_t getTxtRecordCount() const { return header_->txtCount; }
+    MDNSStringRef getTxtRecord(std::size_t i) const { return getString(getFields()[header_->subtypeCount + i]); }
+
+    std::size_t getSubtypeCount() const { return header_->subtypeCount; }
+    MDNSStringRef getSubtype(std::size_t i) const { return getString(getFields()[i]); }
+
+    /**
+     * Value of the first TXT record with key, RFC 6763 section 6.4. Keys
+     * without "=" have an empty value.
+     */
+    bool findTxtValue(const MDNSStringRef &key, MDNSStringRef &value) const;
+
+    /** Size of the block in bytes */
+    std::size_t getByteSize() const { return header_ ? header_->size : 0; }
+
+    bool isArenaAllocated() const { return header_ && header_->arena; }
+
+    MDNSService toService() const;
+
+private:
+
+    struct Field
+    {
+        std::uint32_t offset;
+        std::uint32_t size;
+    };
+
+    struct Header
+    {
+        /** References of a heap block, arena blocks count references of the arena */
+        std::atomic<std::uint32_t> refs;
+        std::uint32_t size;
+        MDNSServiceArena *arena;
+        std::uint32_t port;
+        MDNSInterfaceIndex interfaceIndex;
+        Field name;
+        Field type;
+        Field domain;
+        Field host;
+        std::uint32_t subtypeCount;
+        std::uint32_t txtCount;
+        // Field subtypes[subtypeCount], txt[txtCount], characters
+    };
+
+    static std::size_t computeSize(const MDNSService &service);
+    static Header * construct(void *block, std::size_t size, const MDNSService &service, MDNSServiceArena *arena);
+
+    const Field * getFields() const { return reinterpret_cast<const Field *>(header_ + 1); }
+
+    MDNSStringRef getString(const Field &field) const
+    {
+        return MDNSStringRef(reinterpret_cast<const char *>(header_) + field.offset, field.size);
+    }
+
+    void retain()
+    {
+        if (!header_)
+            return;
+        if (header_->arena)
+            header_->arena->retain();
+        else
+            header_->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void release();
+
+    Header *header_;
+};
+
+/**
+ * Immutable generation of flat services sorted by type, name, domain and
+ * interface index. Added services are copied into the arena of the set, which
+ * is freed at once when the set and all copies of its records are gone.
+ * Shared services reference their existing block instead, so a snapshot of
+ * records that are already flat costs one reference count per record.
+ */
+class MDNSFlatServiceSet
+{
+public:
+
+    typedef std::vector<MDNSFlatService>::const_iterator const_iterator;
+
+    explicit MDNSFlatServiceSet(std::size_t chunkSize = 64 * 1024);
+
+    /** Add a copy of the service, call sort() after the last one */
+    void add(const MDNSService &service);
+    void add(const MDNSFlatService &service);
+    /** Add service without copying its block */
+    void share(const MDNSFlatService &service) { services_.push_back(service); }
+    void reserve(std::size_t count) { services_.reserve(count); }
+    void sort();
+
+    std::size_t size() const { return services_.size(); }
+    bool empty() const { return services_.empty(); }
+    const_iterator begin() const { return services_.begin(); }
+    const_iterator end() const { return services_.end(); }
+
+    const MDNSFlatService * find(const MDNSStringRef &name, const MDNSStringRef &type,
+                                 const MDNSStringRef &domain, MDNSInterfaceIndex interfaceIndex) const;
+
+    /** All services of the given type */
+    std::pair<const_iterator, const_iterator> findByType(const MDNSStringRef &type) const;
+
+    const MDNSServiceArena::Ptr & getArena() const { return arena_; }
+
+private:
+    MDNSServiceArena::Ptr arena_;
+    std::vector<MDNSFlatService> services_;
+};
+
+} // namespace MDNS
+
+#endif /* MDNSFLATSERVICE_HPP_INCLUDED */
@@ -0,0 +1,31 @@
+/*
+ * MDNSHostId.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include "MDNSHostId.hpp"
+
+#ifdef _WIN32
+#include <winsock2.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace MDNS
+{
+
+std::string getDefaultHostId()
+{
+    char buf[256] = { 0 };
+    if (gethostname(buf, sizeof(buf) - 1) != 0)
+        return std::string();
+    std::string host(buf);
+    // Only the first label, "myhost.example.com" -> "myhost"
+    const std::size_t dot = host.find('.');
+    if (dot != std::string::npos)
+        host.erase(dot);
+    return host;
+}
+
+} // namespace MDNS
@@ -0,0 +1,20 @@
+/*
+ * MDNSHostId.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef MDNSHOSTID_HPP_INCLUDED
+#define MDNSHOSTID_HPP_INCLUDED
+
+#include <string>
+
+namespace MDNS
+{
+
+/** Short host name of this machine, e.g. "myhost" for "myhost.example.com" */
+std::string getDefaultHostId();
+
+} // namespace MDNS
+
+#endif /* MDNSHOSTID_HPP_INCLUDED */
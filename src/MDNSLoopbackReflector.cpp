@@ -0,0 +1,167 @@
+/*
+ * MDNSLoopbackReflector.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include "MDNSLoopbackReflector.hpp"
+
+#include <poll.h>
+
+namespace MDNS
+{
+
+MDNSLoopbackReflector::MDNSLoopbackReflector()
+    : running_(false)
+{
+}
+
+MDNSLoopbackReflector::~MDNSLoopbackReflector()
+{
+    stop();
+}
+
+bool MDNSLoopbackReflector::start(std::string *error)
+{
+    stop();
+    MDNSNativeSocket::Options options;
+    options.bindAddress = "127.0.0.1";
+    // Large buffer, thousands of publishers answer the same query at once
+    options.receiveBufferSize = 16 * 1024 * 1024;
+    if (!socket_.open(options, error))
+        return false;
+    running_ = true;
+    thread_ = std::thread(&MDNSLoopbackReflector::run, this);
+    return true;
+}
+
+void MDNSLoopbackReflector::stop()
+{
+    running_ = false;
+    if (thread_.joinable())
+        thread_.join();
+    socket_.close();
+}
+
+bool MDNSLoopbackReflector::addMember(const MDNSNativeSocket::Endpoint &member, std::string *error)
+{
+    Member entry;
+    entry.endpoint = member;
+    entry.proxy = std::make_shared<MDNSNativeSocket>();
+    MDNSNativeSocket::Options options;
+    options.bindAddress = "127.0.0.1";
+    // Unicast responses to a QU query arrive at once, like multicast ones
+    options.receiveBufferSize = 16 * 1024 * 1024;
+    if (!entry.proxy->open(options, error))
+        return false;
+    std::lock_guard<std::mutex> lock(mutex_);
+    members_.push_back(entry);
+    return true;
+}
+
+void MDNSLoopbackReflector::removeMember(const MDNSNativeSocket::Endpoint &member)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = members_.begin(); it != members_.end(); )
+    {
+        if (it->endpoint.address == member.address && it->endpoint.port == member.port)
+            it = members_.erase(it);
+        else
+            ++it;
+    }
+}
+
+MDNSLoopbackReflector::Stats MDNSLoopbackReflector::getStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void MDNSLoopbackReflector::run()
+{
+    std::vector<std::uint8_t> packet;
+    std::vector<Member> polled, members;
+    std::vector<pollfd> fds;
+    while (running_)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            polled = members_;
+        }
+        fds.resize(polled.size() + 1);
+        for (std::size_t i = 0; i < fds.size(); ++i)
+        {
+            fds[i].fd = i == 0 ? socket_.getDescriptor() : polled[i - 1].proxy->getDescriptor();
+            fds[i].events = POLLIN;
+            fds[i].revents = 0;
+        }
+        if (::poll(fds.data(), fds.size(), 100) <= 0)
+            continue;
+
+        // Members may have joined while waiting, their packets can be queued already
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            members = members_;
+        }
+        MDNSNativeSocket::Endpoint source;
+        for (std::size_t i = 0; i < fds.size(); ++i)
+        {
+            if (!(fds[i].revents & POLLIN))
+                continue;
+            MDNSNativeSocket &socket = i == 0 ? socket_ : *polled[i - 1].proxy;
+            const Member *target = 0;
+            for (auto it = members.begin(), iend = members.end(); i > 0 && it != iend && !target; ++it)
+            {
+                if (it->proxy == polled[i - 1].proxy)
+                    target = &*it;
+            }
+            while (socket.receive(packet, source, std::chrono::milliseconds(0)))
+            {
+                // Packets to the proxy of a removed member are dropped
+                if (i == 0 || target)
+                    forward(packet, source, target, members);
+            }
+        }
+    }
+}
+
+void MDNSLoopbackReflector::forward(const std::vector<std::uint8_t> &packet, const MDNSNativeSocket::Endpoint &source,
+                                    const Member *target, const std::vector<Member> &members)
+{
+    const Member *sender = 0;
+    for (auto it = members.begin(), iend = members.end(); it != iend && !sender; ++it)
+    {
+        if (it->endpoint.address == source.address && it->endpoint.port == source.port)
+            sender = &*it;
+    }
+
+    std::uint64_t forwarded = 0;
+    if (target)
+    {
+        MDNSNativeSocket &socket = sender ? *sender->proxy : socket_;
+        if (socket.sendTo(packet.data(), packet.size(), target->endpoint))
+            ++forwarded;
+    }
+    else
+    {
+        // QR bit of the DNS header
+        const bool query = packet.size() > 2 && (packet[2] & 0x80) == 0;
+        MDNSNativeSocket &socket = query && sender ? *sender->proxy : socket_;
+        for (auto it = members.begin(), iend = members.end(); it != iend; ++it)
+        {
+            if (&*it == sender)
+                continue;
+            if (socket.sendTo(packet.data(), packet.size(), it->endpoint))
+                ++forwarded;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.packetsReceived;
+    stats_.packetsForwarded += forwarded;
+    stats_.bytesForwarded += forwarded * packet.size();
+    if (target)
+        stats_.unicastForwarded += forwarded;
+}
+
+} // namespace MDNS
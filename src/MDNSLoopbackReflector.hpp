@@ -0,0 +1,94 @@
+/*
+ * MDNSLoopbackReflector.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef MDNSLOOPBACKREFLECTOR_HPP_INCLUDED
+#define MDNSLOOPBACKREFLECTOR_HPP_INCLUDED
+
+#include "MDNSNativeSocket.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace MDNS
+{
+
+/**
+ * Stand-in for the mDNS multicast group on machines without a network:
+ * every packet sent to the reflector is forwarded to all members except
+ * its sender. Native responders and browsers use the reflector endpoint
+ * as their destination.
+ *
+ * Every member also gets a proxy endpoint on the reflector. Queries are
+ * forwarded from the proxy of their sender, so responders can answer QU
+ * questions directly, and packets sent to a proxy go to its member only,
+ * from the proxy of their sender. Responses to the group are forwarded from
+ * the reflector endpoint, which lets receivers tell them from unicast
+ * responses like the multicast destination address does on a network.
+ */
+class MDNSLoopbackReflector
+{
+public:
+
+    struct Stats
+    {
+        std::uint64_t packetsReceived;
+        std::uint64_t packetsForwarded;
+        std::uint64_t bytesForwarded;
+        /** Packets sent to a proxy and forwarded to its member */
+        std::uint64_t unicastForwarded;
+
+        Stats()
+            : packetsReceived(0), packetsForwarded(0), bytesForwarded(0), unicastForwarded(0)
+        { }
+    };
+
+    MDNSLoopbackReflector();
+
+    ~MDNSLoopbackReflector();
+
+    /** Bind to 127.0.0.1 on an ephemeral port */
+    bool start(std::string *error = 0);
+
+    void stop();
+
+    MDNSNativeSocket::Endpoint getEndpoint() const { return socket_.getLocalEndpoint(); }
+
+    /** Returns false and sets error when the proxy socket can't be opened */
+    bool addMember(const MDNSNativeSocket::Endpoint &member, std::string *error = 0);
+
+    void removeMember(const MDNSNativeSocket::Endpoint &member);
+
+    Stats getStats() const;
+
+private:
+
+    struct Member
+    {
+        MDNSNativeSocket::Endpoint endpoint;
+        std::shared_ptr<MDNSNativeSocket> proxy;
+    };
+
+    void run();
+    /** Forward to the group, or to target only when the packet was sent to its proxy */
+    void forward(const std::vector<std::uint8_t> &packet, const MDNSNativeSocket::Endpoint &source,
+                 const Member *target, const std::vector<Member> &members);
+
+    MDNSNativeSocket socket_;
+    std::thread thread_;
+    std::atomic<bool> running_;
+
+    mutable std::mutex mutex_;
+    std::vector<Member> members_;
+    Stats stats_;
+};
+
+} // namespace MDNS
+
+#endif /* MDNSLOOPBACKREFLECTOR_HPP_INCLUDED */
@@ -0,0 +1,409 @@
+/*
+ * MDNSNativeBrowser.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include "MDNSNativeBrowser.hpp"
+#include <algorithm>
+#include <ctime>
+
+#include <arpa/inet.h>
+
+namespace MDNS
+{
+
+namespace
+{
+
+/** Longest wait, bounds the reaction time to stop() */
+const std::chrono::milliseconds MAX_IDLE_WAIT(100);
+/** Time to wait for SRV and TXT records after the PTR record before asking for them */
+const std::chrono::milliseconds RESOLVE_DELAY(200);
+/** First interval between questions for missing SRV and TXT records, doubled after each */
+const std::chrono::milliseconds RESOLVE_RETRY(1000);
+const std::chrono::milliseconds MAX_RESOLVE_RETRY(60000);
+
+std::chrono::microseconds getThreadCpuTime()
+{
+    timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+        return std::chrono::microseconds(0);
+    return std::chrono::microseconds(static_cast<std::int64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000);
+}
+
+bool endsWith(const std::string &s, const std::string &suffix)
+{
+    return s.size() > suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+} // namespace
+
+MDNSNativeBrowser::MDNSNativeBrowser(const MDNSServiceBrowser::Ptr &browser, const std::string &type,
+                                     const std::string &domain, const Options &options)
+    : browser_(browser)
+    , type_(type)
+    , domain_(domain.empty() ? std::string("local") : domain)
+    , ptrName_(toLowerName(type + "." + domain_))
+    , options_(options)
+    , running_(false)
+    , random_(std::random_device()())
+{
+}
+
+MDNSNativeBrowser::~MDNSNativeBrowser()
+{
+    stop();
+}
+
+bool MDNSNativeBrowser::start(std::string *error)
+{
+    return start(MDNSNativeSocket::Options::multicast(), error);
+}
+
+bool MDNSNativeBrowser::start(const MDNSNativeSocket::Options &socketOptions, std::string *error)
+{
+    stop();
+    if (!socket_.open(socketOptions, error))
+        return false;
+    instances_.clear();
+    running_ = true;
+    thread_ = std::thread(&MDNSNativeBrowser::run, this);
+    return true;
+}
+
+void MDNSNativeBrowser::stop()
+{
+    running_ = false;
+    if (thread_.joinable())
+        thread_.join();
+    socket_.close();
+}
+
+MDNSNativeBrowser::Stats MDNSNativeBrowser::getStats() const
+{
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    return stats_;
+}
+
+void MDNSNativeBrowser::run()
+{
+    std::uniform_int_distribution<long long> initialDelay(options_.minInitialDelay.count(), options_.maxInitialDelay.count());
+    Clock::time_point nextQuery = Clock::now() + std::chrono::milliseconds(initialDelay(random_));
+    std::chrono::milliseconds interval = options_.firstInterval;
+    Clock::time_point nextMaintenance = Clock::time_point::max();
+    unsigned int queries = 0;
+
+    std::vector<std::uint8_t> packet;
+    MDNSMessage message;
+    while (running_)
+    {
+        Clock::time_point now = Clock::now();
+        if (now >= nextQuery)
+        {
+            sendQuery(now, queries < options_.unicastQueries);
+            nextQuery = now + interval;
+            if (++queries >= options_.burstQueries)
+            {
+                interval = std::min(std::chrono::duration_cast<std::chrono::milliseconds>(interval * options_.backoffFactor),
+                                    options_.maxInterval);
+            }
+        }
+        if (now >= nextMaintenance)
+            nextMaintenance = maintain(now);
+
+        const Clock::time_point wakeup = std::min(std::min(nextQuery, nextMaintenance), now + MAX_IDLE_WAIT);
+        const std::chrono::milliseconds timeout =
+            std::chrono::duration_cast<std::chrono::milliseconds>(wakeup - now) + std::chrono::milliseconds(1);
+
+        MDNSNativeSocket::Endpoint source;
+        std::uint32_t destinationAddress = 0;
+        if (socket_.receive(packet, source, timeout, 0, &destinationAddress) &&
+            decodeMessage(packet.data(), packet.size(), message) && message.isResponse())
+        {
+            // Multicast responses are sent to the group or come through the reflector
+            const bool multicast = (ntohl(destinationAddress) & 0xF0000000u) == 0xE0000000u ||
+                (source.address == options_.destination.address && source.port == options_.destination.port);
+            nextMaintenance = std::min(nextMaintenance, handleResponse(message, !multicast, Clock::now()));
+        }
+
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        stats_.cpuTime = getThreadCpuTime();
+    }
+}
+
+void MDNSNativeBrowser::sendQuery(Clock::time_point now, bool unicastResponse)
+{
+    MDNSMessage message;
+    message.questions.push_back(MDNSQuestion(type_ + "." + domain_, MDNS_TYPE_PTR,
+                                             unicastResponse ? MDNS_CLASS_IN | MDNS_CLASS_QU : MDNS_CLASS_IN));
+    std::size_t size = 12 + ptrName_.size() + 6;
+
+    // Ask for the SRV and TXT records that are missing or to be refreshed
+    for (auto it = instances_.begin(), iend = instances_.end(); it != iend && size < options_.maxPacketSize / 2; ++it)
+    {
+        Instance &instance = it->second;
+        if (instance.askSrv)
+        {
+            message.questions.push_back(MDNSQuestion(instance.name, MDNS_TYPE_SRV));
+            size += instance.name.size() + 6;
+        }
+        if (instance.askTxt)
+        {
+            message.questions.push_back(MDNSQuestion(instance.name, MDNS_TYPE_TXT));
+            size += instance.name.size() + 6;
+        }
+        instance.askSrv = false;
+        instance.askTxt = false;
+    }
+
+    // Known answers with more than half of their TTL left, as many as fit
+    // into one packet (no truncated multi-packet queries)
+    for (auto it = instances_.begin(), iend = instances_.end(); it != iend; ++it)
+    {
+        const Instance &instance = it->second;
+        if (!instance.ptr.present)
+            continue;
+        const std::int64_t remaining =
+            std::chrono::duration_cast<std::chrono::seconds>(instance.ptr.expires() - now).count();
+        if (remaining <= static_cast<std::int64_t>(instance.ptr.ttl / 2))
+            continue;
+        const std::size_t recordSize = ptrName_.size() + instance.name.size() + 16;
+        if (size + recordSize > options_.maxPacketSize)
+            break;
+        message.answers.push_back(MDNSRecord::makePtr(type_ + "." + domain_, instance.name, static_cast<std::uint32_t>(remaining)));
+        size += recordSize;
+    }
+
+    const std::string data = encodeMessage(message);
+    if (socket_.sendTo(data.data(), data.size(), options_.destination))
+    {
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        ++stats_.queriesSent;
+    }
+}
+
+MDNSNativeBrowser::Clock::time_point MDNSNativeBrowser::handleResponse(const MDNSMessage &message, bool unicast, Clock::time_point now)
+{
+    Clock::time_point next = Clock::time_point::max();
+    std::vector<std::string> touched;
+    std::uint64_t records = 0;
+
+    const std::vector<MDNSRecord> *sections[] = { &message.answers, &message.additionals };
+    // PTR records first, SRV and TXT may come before the PTR they belong to
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        for (int s = 0; s < 2; ++s)
+        {
+            for (auto it = sections[s]->begin(), iend = sections[s]->end(); it != iend; ++it)
+            {
+                const MDNSRecord &record = *it;
+                if (pass == 0 && record.type == MDNS_TYPE_PTR && toLowerName(record.name) == ptrName_)
+                {
+                    ++records;
+                    const std::string key = toLowerName(record.target);
+                    if (record.ttl == 0)
+                    {
+                        auto found = instances_.find(key);
+                        if (found != instances_.end())
+                            remove(found);
+                        continue;
+                    }
+                    Instance &instance = instances_[key];
+                    instance.name = record.target;
+                    instance.ptr.update(record.ttl, now, randomJitter());
+                    // Missing records are asked for again from now on
+                    instance.resolveAt = now + RESOLVE_DELAY;
+                    instance.resolveAttempts = 0;
+                    touched.push_back(key);
+                }
+                else if (pass == 1 && (record.type == MDNS_TYPE_SRV || record.type == MDNS_TYPE_TXT))
+                {
+                    const std::string key = toLowerName(record.name);
+                    if (!endsWith(key, "." + ptrName_))
+                        continue;
+                    ++records;
+                    auto found = instances_.find(key);
+                    if (record.ttl == 0)
+                    {
+                        if (found == instances_.end())
+                            continue;
+                        Instance &instance = found->second;
+                        (record.type == MDNS_TYPE_SRV ? instance.srv : instance.txt).present = false;
+                        unreport(instance);
+                        if (instance.isEmpty())
+                        {
+                            instances_.erase(found);
+                            continue;
+                        }
+                        instance.resolveAt = now + RESOLVE_DELAY;
+                        touched.push_back(key);
+                        continue;
+                    }
+                    if (found == instances_.end())
+                    {
+                        // Kept until the PTR record arrives or the record expires
+                        found = instances_.insert(std::make_pair(key, Instance())).first;
+                        found->second.name = record.name;
+                    }
+                    Instance &instance = found->second;
+                    if (record.type == MDNS_TYPE_SRV)
+                    {
+                        if (!instance.srv.present || instance.host != record.target || instance.port != record.port)
+                            instance.reported = false;
+                        instance.srv.update(record.ttl, now, randomJitter());
+                        instance.host = record.target;
+                        instance.port = record.port;
+                    }
+                    else
+                    {
+                        if (!instance.txt.present || instance.txtRecords != record.txt)
+                            instance.reported = false;
+                        instance.txt.update(record.ttl, now, randomJitter());
+                        instance.txtRecords = record.txt;
+                    }
+                    touched.push_back(key);
+                }
+            }
+        }
+    }
+
+    std::uint64_t added = 0;
+    for (auto it = touched.begin(), iend = touched.end(); it != iend; ++it)
+    {
+        auto found = instances_.find(*it);
+        if (found == instances_.end())
+            continue;
+        Instance &instance = found->second;
+        next = std::min(next, nextEvent(instance));
+        if (!instance.isResolved() || instance.reported)
+            continue;
+        instance.reported = true;
+        const std::vector<std::string> labels = splitName(instance.name);
+        MDNSService service;
+        service.setName(labels.empty() ? std::string() : labels[0])
+            .setType(type_)
+            .setDomain(domain_)
+            .setHost(instance.host)
+            .setPort(instance.port)
+            .setTxtRecords(instance.txtRecords);
+        ++added;
+        if (browser_)
+            browser_->onNewService(service);
+    }
+
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    ++stats_.packetsReceived;
+    if (unicast)
+        ++stats_.unicastPacketsReceived;
+    stats_.recordsReceived += records;
+    stats_.servicesAdded += added;
+    return next;
+}
+
+MDNSNativeBrowser::Clock::time_point MDNSNativeBrowser::maintain(Clock::time_point now)
+{
+    Clock::time_point next = Clock::time_point::max();
+    bool query = false;
+    for (auto it = instances_.begin(); it != instances_.end(); )
+    {
+        Instance &instance = it->second;
+        if (instance.ptr.present && instance.ptr.expires() <= now)
+        {
+            remove(it++);
+            continue;
+        }
+        bool lost = false;
+        if (instance.srv.present && instance.srv.expires() <= now)
+        {
+            instance.srv.present = false;
+            lost = true;
+        }
+        if (instance.txt.present && instance.txt.expires() <= now)
+        {
+            instance.txt.present = false;
+            lost = true;
+        }
+        if (instance.isEmpty())
+        {
+            remove(it++);
+            continue;
+        }
+        if (lost)
+        {
+            unreport(instance);
+            instance.resolveAt = now;
+        }
+
+        // Records of instances without PTR record are not asked for
+        if (instance.ptr.present)
+        {
+            // Refreshed PTR records are not listed as known answers anymore,
+            // so responders answer the PTR question again
+            query = instance.ptr.refresh(now) || query;
+            if (instance.srv.refresh(now))
+                query = instance.askSrv = true;
+            if (instance.txt.refresh(now))
+                query = instance.askTxt = true;
+            if (!instance.isResolved() && instance.resolveAt <= now)
+            {
+                instance.askSrv = instance.askSrv || !instance.srv.present;
+                instance.askTxt = instance.askTxt || !instance.txt.present;
+                query = true;
+                instance.resolveAt = now + std::min(RESOLVE_RETRY * (1 << std::min(instance.resolveAttempts, 6u)),
+                                                    MAX_RESOLVE_RETRY);
+                ++instance.resolveAttempts;
+            }
+        }
+        next = std::min(next, nextEvent(instance));
+        ++it;
+    }
+    if (query)
+        sendQuery(now, false);
+    return next;
+}
+
+MDNSNativeBrowser::Clock::time_point MDNSNativeBrowser::nextEvent(const Instance &instance)
+{
+    Clock::time_point next = Clock::time_point::max();
+    const Record *records[] = { &instance.ptr, &instance.srv, &instance.txt };
+    for (int i = 0; i < 3; ++i)
+    {
+        if (!records[i]->present)
+            continue;
+        next = std::min(next, records[i]->expires());
+        if (instance.ptr.present)
+            next = std::min(next, records[i]->refreshAt());
+    }
+    if (instance.ptr.present && !instance.isResolved())
+        next = std::min(next, instance.resolveAt);
+    return next;
+}
+
+unsigned int MDNSNativeBrowser::randomJitter()
+{
+    return std::uniform_int_distribution<unsigned int>(0, 20)(random_);
+}
+
+void MDNSNativeBrowser::remove(std::map<std::string, Instance>::iterator it)
+{
+    Instance instance = it->second;
+    instances_.erase(it);
+    unreport(instance);
+}
+
+void MDNSNativeBrowser::unreport(Instance &instance)
+{
+    if (!instance.reported)
+        return;
+    instance.reported = false;
+    const std::vector<std::string> labels = splitName(instance.name);
+    {
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        ++stats_.servicesRemoved;
+    }
+    if (browser_)
+        browser_->onRemovedService(labels.empty() ? std::string() : labels[0], type_, domain_, MDNS_IF_ANY);
+}
+
+} // namespace MDNS
@@ -0,0 +1,242 @@
+/*
+ * MDNSNativeBrowser.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef MDNSNATIVEBROWSER_HPP_INCLUDED
+#define MDNSNATIVEBROWSER_HPP_INCLUDED
+
+#include "MDNSManager.hpp"
+#include "MDNSNativeSocket.hpp"
+#include "MDNSPacket.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace MDNS
+{
+
+/**
+ * Standalone, daemon-free browser for one service type on its own socket.
+ * It is not an MDNSManager backend; it only reports to an MDNSServiceBrowser
+ * from its own thread, like the browsers registered at MDNSManager. Sends PTR
+ * queries with exponential backoff and known answers and resolves instances
+ * from the SRV and TXT records.
+ *
+ * Every PTR, SRV and TXT record expires after its own TTL and is refreshed
+ * by queries at 80, 85, 90 and 95% of it, plus up to 2% at random (RFC 6762
+ * section 5.2). Goodbyes remove records immediately. An instance is removed
+ * when its PTR record goes away; when its SRV or TXT record goes away, it is
+ * reported removed until it is resolved again. Missing SRV and TXT records
+ * are asked for again with backoff, and whenever the PTR record arrives.
+ *
+ * The first queries may ask for unicast responses (QU bit, RFC 6762 section
+ * 5.4), which responders don't need to delay and which don't load the other
+ * hosts. Unicast responses are processed like multicast ones. On a network
+ * this requires the socket of start() without options, bound to MDNS_PORT
+ * and member of the group: from an ephemeral port the browser is a legacy
+ * unicast querier, whose QU bit is ignored and which receives no multicast
+ * answers. Ephemeral ports are meant for MDNSLoopbackReflector.
+ */
+class MDNSNativeBrowser
+{
+public:
+
+    typedef std::chrono::steady_clock Clock;
+
+    struct Options
+    {
+        /** Where queries go: the mDNS group or a loopback reflector */
+        MDNSNativeSocket::Endpoint destination;
+        /** Random delay of the first query, RFC 6762 section 5.2 */
+        std::chrono::milliseconds minInitialDelay;
+        std::chrono::milliseconds maxInitialDelay;
+        /** Interval between the first queries */
+        std::chrono::milliseconds firstInterval;
+        /** Number of queries sent firstInterval apart before the backoff starts */
+        unsigned int burstQueries;
+        /** Factor the interval grows by after each further query */
+        double backoffFactor;
+        std::chrono::milliseconds maxInterval;
+        /** Number of initial queries with the QU bit set */
+        unsigned int unicastQueries;
+        std::size_t maxPacketSize;
+
+        Options()
+            : destination(MDNS_MULTICAST_ADDRESS, MDNS_PORT)
+            , minInitialDelay(20)
+            , maxInitialDelay(120)
+            , firstInterval(1000)
+            , burstQueries(1)
+            , backoffFactor(2.0)
+            , maxInterval(std::chrono::minutes(60))
+            , unicastQueries(0)
+            , maxPacketSize(8900)
+        { }
+
+        /**
+         * Aggressive startup: first query without delay, three QU queries
+         * 250 ms apart, then the standard backoff. For short-lived browsers
+         * that need the first results fast.
+         */
+        static Options startupBurst()
+        {
+            Options options;
+            options.minInitialDelay = std::chrono::milliseconds(0);
+            options.maxInitialDelay = std::chrono::milliseconds(0);
+            options.firstInterval = std::chrono::milliseconds(250);
+            options.burstQueries = 3;
+            options.unicastQueries = 3;
+            return options;
+        }
+    };
+
+    struct Stats
+    {
+        std::uint64_t queriesSent;
+        std::uint64_t packetsReceived;
+        /** Packets sent directly to this browser, i.e. answers to QU questions */
+        std::uint64_t unicastPacketsReceived;
+        std::uint64_t recordsReceived;
+        std::uint64_t servicesAdded;
+        std::uint64_t servicesRemoved;
+        /** CPU time consumed by the browser thread */
+        std::chrono::microseconds cpuTime;
+
+        Stats()
+            : queriesSent(0), packetsReceived(0), unicastPacketsReceived(0), recordsReceived(0),
+              servicesAdded(0), servicesRemoved(0), cpuTime(0)
+        { }
+    };
+
+    MDNSNativeBrowser(const MDNSServiceBrowser::Ptr &browser, const std::string &type,
+                      const std::string &domain = std::string(), const Options &options = Options());
+
+    ~MDNSNativeBrowser();
+
+    /** Start on MDNSNativeSocket::Options::multicast() */
+    bool start(std::string *error = 0);
+
+    bool start(const MDNSNativeSocket::Options &socketOptions, std::string *error = 0);
+
+    /** Stop browsing, no removal events are reported for known instances */
+    void stop();
+
+    MDNSNativeSocket::Endpoint getLocalEndpoint() const { return socket_.getLocalEndpoint(); }
+
+    Stats getStats() const;
+
+private:
+
+    /** Cached record of an instance */
+    struct Record
+    {
+        bool present;
+        std::uint32_t ttl;
+        Clock::time_point received;
+        /** Refresh queries sent since the record was received */
+        unsigned int refreshes;
+        /** Random delay of the refresh queries in 1/1000 of the TTL */
+        unsigned int jitter;
+
+        Record()
+            : present(false), ttl(0), refreshes(0), jitter(0)
+        { }
+
+        void update(std::uint32_t recordTtl, Clock::time_point now, unsigned int randomJitter)
+        {
+            present = true;
+            ttl = recordTtl;
+            received = now;
+            refreshes = 0;
+            jitter = randomJitter;
+        }
+
+        Clock::time_point expires() const { return received + std::chrono::seconds(ttl); }
+
+        /** Passes all refresh times up to now, returns true if one was reached */
+        bool refresh(Clock::time_point now)
+        {
+            bool due = false;
+            for (; present && refreshAt() <= now; ++refreshes)
+                due = true;
+            return due;
+        }
+
+        /** At 80, 85, 90 and 95% of the TTL, max() after the last refresh */
+        Clock::time_point refreshAt() const
+        {
+            if (refreshes >= 4)
+                return Clock::time_point::max();
+            return received + std::chrono::milliseconds(static_cast<std::int64_t>(ttl) * (800 + 50 * refreshes + jitter));
+        }
+    };
+
+    struct Instance
+    {
+        std::string name;
+        Record ptr;
+        Record srv;
+        Record txt;
+        std::string host;
+        std::uint16_t port;
+        std::vector<std::string> txtRecords;
+        /** Next time to ask for missing SRV and TXT records */
+        Clock::time_point resolveAt;
+        unsigned int resolveAttempts;
+        /** Questions for the next query */
+        bool askSrv;
+        bool askTxt;
+        /** Reported to the browser and not changed since */
+        bool reported;
+
+        Instance()
+            : port(0), resolveAttempts(0), askSrv(false), askTxt(false), reported(false)
+        { }
+
+        bool isResolved() const { return ptr.present && srv.present && txt.present; }
+        bool isEmpty() const { return !ptr.present && !srv.present && !txt.present; }
+    };
+
+    void run();
+    void sendQuery(Clock::time_point now, bool unicastResponse);
+    /** Returns the next time maintain() needs to run for the updated instances */
+    Clock::time_point handleResponse(const MDNSMessage &message, bool unicast, Clock::time_point now);
+    /** Expire records and send refresh and resolve queries, returns the next time to look again */
+    Clock::time_point maintain(Clock::time_point now);
+    /** Next time maintain() needs to run for the instance */
+    static Clock::time_point nextEvent(const Instance &instance);
+    unsigned int randomJitter();
+    void remove(std::map<std::string, Instance>::iterator it);
+    /** Report removal of a reported instance that lost a record */
+    void unreport(Instance &instance);
+
+    MDNSServiceBrowser::Ptr browser_;
+    std::string type_;
+    std::string domain_;
+    /** "_type._tcp.local", lower case */
+    std::string ptrName_;
+    Options options_;
+
+    MDNSNativeSocket socket_;
+    std::thread thread_;
+    std::atomic<bool> running_;
+    std::mt19937 random_;
+
+    /** Lower case instance name to instance, only used by the browser thread */
+    std::map<std::string, Instance> instances_;
+
+    mutable std::mutex statsMutex_;
+    Stats stats_;
+};
+
+} // namespace MDNS
+
+#endif /* MDNSNATIVEBROWSER_HPP_INCLUDED */
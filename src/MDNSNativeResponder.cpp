@@ -0,0 +1,348 @@
+/*
+ * MDNSNativeResponder.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include "MDNSNativeResponder.hpp"
+#include <utility>
+
+namespace MDNS
+{
+
+namespace
+{
+
+const std::chrono::milliseconds MAX_IDLE_WAIT(10);
+
+/** Upper bound of the encoded size of a record, without compression */
+std::size_t estimateSize(const MDNSRecord &record)
+{
+    std::size_t size = record.name.size() + 2 + 10;
+    switch (record.type)
+    {
+        case MDNS_TYPE_PTR:
+            size += record.target.size() + 2;
+            break;
+        case MDNS_TYPE_SRV:
+            size += 6 + record.target.size() + 2;
+            break;
+        case MDNS_TYPE_TXT:
+            size += 1;
+            for (auto it = record.txt.begin(), iend = record.txt.end(); it != iend; ++it)
+                size += it->size() + 1;
+            break;
+        default:
+            size += 16;
+            break;
+    }
+    return size;
+}
+
+} // namespace
+
+MDNSNativeResponder::MDNSNativeResponder(const Options &options)
+    : options_(options)
+    , running_(false)
+    , random_(std::random_device()())
+{
+}
+
+MDNSNativeResponder::~MDNSNativeResponder()
+{
+    stop();
+}
+
+bool MDNSNativeResponder::start(std::string *error)
+{
+    return start(MDNSNativeSocket::Options::multicast(), error);
+}
+
+bool MDNSNativeResponder::start(const MDNSNativeSocket::Options &socketOptions, std::string *error)
+{
+    stop();
+    if (!socket_.open(socketOptions, error))
+        return false;
+    running_ = true;
+    thread_ = std::thread(&MDNSNativeResponder::run, this);
+    return true;
+}
+
+void MDNSNativeResponder::stop()
+{
+    running_ = false;
+    if (thread_.joinable())
+        thread_.join();
+    socket_.close();
+}
+
+void MDNSNativeResponder::addService(const MDNSService &service, std::uint32_t ttl)
+{
+    Instance instance;
+    instance.service = service;
+    if (instance.service.getHost().empty())
+        instance.service.setHost(options_.hostName);
+    const std::string domain = service.getDomain().empty() ? std::string("local") : service.getDomain();
+    instance.instanceName = makeInstanceName(service.getName(), service.getType(), domain);
+    instance.ptrNames.push_back(service.getType() + "." + domain);
+    const std::vector<std::string> &subtypes = service.getSubtypes();
+    for (auto it = subtypes.begin(), iend = subtypes.end(); it != iend; ++it)
+        instance.ptrNames.push_back(*it + "._sub." + service.getType() + "." + domain);
+    instance.ttl = ttl ? ttl : options_.ttl;
+
+    const std::string key = toLowerName(instance.instanceName);
+    const Clock::time_point now = Clock::now();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = instance.ptrNames.begin(), iend = instance.ptrNames.end(); it != iend; ++it)
+        ptrIndex_[toLowerName(*it)].insert(key);
+    instances_[key] = instance;
+
+    // RFC 6762 section 8.3: announcements one second apart
+    for (unsigned int i = 0; i < options_.announcements; ++i)
+    {
+        Pending pending;
+        pending.instances.insert(key);
+        pending_.insert(std::make_pair(now + std::chrono::seconds(i), pending));
+    }
+}
+
+void MDNSNativeResponder::removeService(const std::string &name, const std::string &type, const std::string &domain)
+{
+    const std::string key = toLowerName(makeInstanceName(name, type, domain));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = instances_.find(key);
+    if (it == instances_.end())
+        return;
+
+    Pending pending;
+    appendRecords(it->second, 0, pending.goodbyes);
+    for (auto ptr = it->second.ptrNames.begin(), pend = it->second.ptrNames.end(); ptr != pend; ++ptr)
+    {
+        auto index = ptrIndex_.find(toLowerName(*ptr));
+        if (index != ptrIndex_.end())
+        {
+            index->second.erase(key);
+            if (index->second.empty())
+                ptrIndex_.erase(index);
+        }
+    }
+    instances_.erase(it);
+    pending_.insert(std::make_pair(Clock::now(), pending));
+}
+
+std::size_t MDNSNativeResponder::getServiceCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return instances_.size();
+}
+
+MDNSNativeResponder::Stats MDNSNativeResponder::getStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void MDNSNativeResponder::appendRecords(const Instance &instance, std::uint32_t ttl, std::vector<MDNSRecord> &records) const
+{
+    for (auto it = instance.ptrNames.begin(), iend = instance.ptrNames.end(); it != iend; ++it)
+        records.push_back(MDNSRecord::makePtr(*it, instance.instanceName, ttl));
+    records.push_back(MDNSRecord::makeSrv(instance.instanceName, instance.service.getHost(),
+                                          static_cast<std::uint16_t>(instance.service.getPort()), ttl));
+    records.push_back(MDNSRecord::makeTxt(instance.instanceName, instance.service.getTxtRecords(), ttl));
+}
+
+void MDNSNativeResponder::run()
+{
+    typedef std::pair<std::uint32_t, std::uint16_t> EndpointKey;
+
+    std::vector<std::uint8_t> packet;
+    MDNSMessage message;
+    while (running_)
+    {
+        Clock::time_point now = Clock::now();
+        std::vector<MDNSRecord> records;
+        std::map<EndpointKey, std::vector<MDNSRecord> > unicastRecords;
+        Clock::time_point wakeup = now + MAX_IDLE_WAIT;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            // Answer every instance at most once per batch and destination
+            std::set<std::string> due;
+            std::map<EndpointKey, std::set<std::string> > unicastDue;
+            while (!pending_.empty() && pending_.begin()->first <= now)
+            {
+                Pending &pending = pending_.begin()->second;
+                if (pending.unicast)
+                {
+                    const EndpointKey key(pending.destination.address, pending.destination.port);
+                    unicastDue[key].insert(pending.instances.begin(), pending.instances.end());
+                }
+                else
+                {
+                    due.insert(pending.instances.begin(), pending.instances.end());
+                    records.insert(records.end(), pending.goodbyes.begin(), pending.goodbyes.end());
+                }
+                pending_.erase(pending_.begin());
+            }
+            for (auto it = due.begin(), iend = due.end(); it != iend; ++it)
+            {
+                auto instance = instances_.find(*it);
+                if (instance != instances_.end())
+                {
+                    appendRecords(instance->second, instance->second.ttl, records);
+                    instance->second.lastMulticast = now;
+                }
+            }
+            for (auto dest = unicastDue.begin(), dend = unicastDue.end(); dest != dend; ++dest)
+            {
+                for (auto it = dest->second.begin(), iend = dest->second.end(); it != iend; ++it)
+                {
+                    // Already part of the multicast response of this batch
+                    if (due.count(*it))
+                        continue;
+                    auto instance = instances_.find(*it);
+                    if (instance != instances_.end())
+                        appendRecords(instance->second, instance->second.ttl, unicastRecords[dest->first]);
+                }
+            }
+            if (!pending_.empty() && pending_.begin()->first < wakeup)
+                wakeup = pending_.begin()->first;
+        }
+        if (!records.empty())
+            send(records, options_.destination, false);
+        for (auto it = unicastRecords.begin(), iend = unicastRecords.end(); it != iend; ++it)
+        {
+            MDNSNativeSocket::Endpoint destination;
+            destination.address = it->first.first;
+            destination.port = it->first.second;
+            send(it->second, destination, true);
+        }
+
+        MDNSNativeSocket::Endpoint source;
+        const std::chrono::milliseconds timeout =
+            std::chrono::duration_cast<std::chrono::milliseconds>(wakeup - Clock::now());
+        if (!socket_.receive(packet, source, timeout.count() > 0 ? timeout : std::chrono::milliseconds(0)))
+            continue;
+        if (!decodeMessage(packet.data(), packet.size(), message) || message.isResponse())
+            continue;
+        handleQuery(message, source, Clock::now());
+    }
+}
+
+void MDNSNativeResponder::handleQuery(const MDNSMessage &query, const MDNSNativeSocket::Endpoint &source, Clock::time_point now)
+{
+    // Known answers: lower case PTR name and target with remaining TTL
+    std::map<std::pair<std::string, std::string>, std::uint32_t> knownAnswers;
+    for (auto it = query.answers.begin(), iend = query.answers.end(); it != iend; ++it)
+    {
+        if (it->type == MDNS_TYPE_PTR)
+            knownAnswers[std::make_pair(toLowerName(it->name), toLowerName(it->target))] = it->ttl;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.queriesReceived;
+
+    Pending shared, unique, unicast;
+    unicast.unicast = true;
+    unicast.destination = source;
+    auto answer = [this, &unicast, now](Pending &multicast, bool unicastRequested, const std::string &key)
+    {
+        const Instance &instance = instances_[key];
+        // RFC 6762 section 5.4: unicast only if peers got the records recently
+        if (unicastRequested && now - instance.lastMulticast < std::chrono::seconds(instance.ttl) / 4)
+            unicast.instances.insert(key);
+        else
+            multicast.instances.insert(key);
+    };
+
+    for (auto q = query.questions.begin(), qend = query.questions.end(); q != qend; ++q)
+    {
+        const std::string key = toLowerName(q->name);
+        if (q->isUnicastResponse())
+            ++stats_.unicastQuestionsReceived;
+        if (q->type == MDNS_TYPE_PTR || q->type == MDNS_TYPE_ANY)
+        {
+            auto index = ptrIndex_.find(key);
+            if (index != ptrIndex_.end())
+            {
+                for (auto it = index->second.begin(), iend = index->second.end(); it != iend; ++it)
+                {
+                    // RFC 6762 section 7.1: suppress answers the querier knows
+                    // with at least half of the TTL left
+                    auto known = knownAnswers.find(std::make_pair(key, *it));
+                    if (known != knownAnswers.end() && known->second >= instances_[*it].ttl / 2)
+                    {
+                        ++stats_.suppressedAnswers;
+                        continue;
+                    }
+                    answer(shared, q->isUnicastResponse(), *it);
+                }
+            }
+        }
+        if (q->type == MDNS_TYPE_SRV || q->type == MDNS_TYPE_TXT || q->type == MDNS_TYPE_ANY)
+        {
+            if (instances_.count(key))
+                answer(unique, q->isUnicastResponse(), key);
+        }
+    }
+
+    // Unique records are answered immediately, shared ones after a random delay
+    if (!unique.instances.empty())
+        pending_.insert(std::make_pair(now, unique));
+    if (!shared.instances.empty())
+    {
+        std::uniform_int_distribution<long long> delay(options_.minResponseDelay.count(), options_.maxResponseDelay.count());
+        pending_.insert(std::make_pair(now + std::chrono::milliseconds(delay(random_)), shared));
+    }
+    if (!unicast.instances.empty())
+    {
+        std::uniform_int_distribution<long long> delay(options_.minUnicastResponseDelay.count(), options_.maxUnicastResponseDelay.count());
+        pending_.insert(std::make_pair(now + std::chrono::milliseconds(delay(random_)), unicast));
+    }
+}
+
+void MDNSNativeResponder::send(const std::vector<MDNSRecord> &records, const MDNSNativeSocket::Endpoint &destination, bool unicast)
+{
+    const MDNSRecord hostRecord = MDNSRecord::makeA(options_.hostName, options_.hostAddress, 120);
+    const std::size_t baseSize = 12 + estimateSize(hostRecord);
+
+    MDNSMessage message;
+    message.flags = MDNS_FLAG_RESPONSE | MDNS_FLAG_AUTHORITATIVE;
+    std::size_t size = baseSize;
+    std::uint64_t packets = 0, sent = 0;
+
+    auto flush = [&]()
+    {
+        if (message.answers.empty())
+            return;
+        message.additionals.push_back(hostRecord);
+        const std::string data = encodeMessage(message);
+        if (socket_.sendTo(data.data(), data.size(), destination))
+        {
+            ++packets;
+            sent += message.answers.size() + message.additionals.size();
+        }
+        message.answers.clear();
+        message.additionals.clear();
+        size = baseSize;
+    };
+
+    for (auto it = records.begin(), iend = records.end(); it != iend; ++it)
+    {
+        const std::size_t recordSize = estimateSize(*it);
+        if (size + recordSize > options_.maxPacketSize)
+            flush();
+        message.answers.push_back(*it);
+        size += recordSize;
+    }
+    flush();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.packetsSent += packets;
+    stats_.recordsSent += sent;
+    if (unicast)
+        stats_.unicastPacketsSent += packets;
+}
+
+} // namespace MDNS
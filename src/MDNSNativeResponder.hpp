@@ -0,0 +1,167 @@
+/*
+ * MDNSNativeResponder.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef MDNSNATIVERESPONDER_HPP_INCLUDED
+#define MDNSNATIVERESPONDER_HPP_INCLUDED
+
+#include "MDNSManager.hpp"
+#include "MDNSNativeSocket.hpp"
+#include "MDNSPacket.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace MDNS
+{
+
+/**
+ * Standalone, daemon-free responder for many services on its own socket,
+ * used to simulate publishers. Like MDNSNativeBrowser it is not an
+ * MDNSManager backend. Answers PTR, SRV and TXT questions with known-answer
+ * suppression, announces new services and sends goodbyes. Probing is not
+ * implemented, names are assumed to be unique.
+ *
+ * Questions with the unicast-response (QU) bit are answered by unicast to
+ * the querier when the records were multicast within the last quarter of
+ * their TTL, and by multicast otherwise (RFC 6762 section 5.4).
+ */
+class MDNSNativeResponder
+{
+public:
+
+    typedef std::chrono::steady_clock Clock;
+
+    struct Options
+    {
+        /** Where multicast responses go: the mDNS group or a loopback reflector */
+        MDNSNativeSocket::Endpoint destination;
+        std::string hostName;
+        /** IPv4 address of hostName in network byte order */
+        std::uint32_t hostAddress;
+        /** TTL of PTR, SRV and TXT records of services added without one */
+        std::uint32_t ttl;
+        /** Random delay of responses to shared (PTR) questions, RFC 6762 section 6 */
+        std::chrono::milliseconds minResponseDelay;
+        std::chrono::milliseconds maxResponseDelay;
+        /** Random delay of unicast responses to QU questions */
+        std::chrono::milliseconds minUnicastResponseDelay;
+        std::chrono::milliseconds maxUnicastResponseDelay;
+        /** Number of unsolicited announcements of a new service, one second apart */
+        unsigned int announcements;
+        std::size_t maxPacketSize;
+
+        Options()
+            : destination(MDNS_MULTICAST_ADDRESS, MDNS_PORT)
+            , hostName("localhost.local")
+            , hostAddress(MDNSNativeSocket::Endpoint("127.0.0.1", 0).address)
+            , ttl(4500)
+            , minResponseDelay(20)
+            , maxResponseDelay(120)
+            , minUnicastResponseDelay(0)
+            , maxUnicastResponseDelay(10)
+            , announcements(2)
+            , maxPacketSize(8900)
+        { }
+    };
+
+    struct Stats
+    {
+        std::uint64_t queriesReceived;
+        std::uint64_t packetsSent;
+        std::uint64_t recordsSent;
+        std::uint64_t suppressedAnswers;
+        /** Questions with the QU bit, and responses sent by unicast */
+        std::uint64_t unicastQuestionsReceived;
+        std::uint64_t unicastPacketsSent;
+
+        Stats()
+            : queriesReceived(0), packetsSent(0), recordsSent(0), suppressedAnswers(0),
+              unicastQuestionsReceived(0), unicastPacketsSent(0)
+        { }
+    };
+
+    explicit MDNSNativeResponder(const Options &options = Options());
+
+    ~MDNSNativeResponder();
+
+    /** Start on MDNSNativeSocket::Options::multicast() */
+    bool start(std::string *error = 0);
+
+    bool start(const MDNSNativeSocket::Options &socketOptions, std::string *error = 0);
+
+    void stop();
+
+    MDNSNativeSocket::Endpoint getLocalEndpoint() const { return socket_.getLocalEndpoint(); }
+
+    /**
+     * Publish service, an existing service with the same name is replaced and
+     * announced again. The host of the service defaults to Options::hostName.
+     * ttl 0 uses Options::ttl.
+     */
+    void addService(const MDNSService &service, std::uint32_t ttl = 0);
+
+    /** Withdraw service and send a goodbye */
+    void removeService(const std::string &name, const std::string &type, const std::string &domain = std::string());
+
+    std::size_t getServiceCount() const;
+
+    Stats getStats() const;
+
+private:
+
+    struct Instance
+    {
+        MDNSService service;
+        std::string instanceName;
+        /** "_type._tcp.local" and "_sub._sub._type._tcp.local" */
+        std::vector<std::string> ptrNames;
+        std::uint32_t ttl;
+        Clock::time_point lastMulticast;
+    };
+
+    struct Pending
+    {
+        /** Lower case instance names to answer or announce */
+        std::set<std::string> instances;
+        std::vector<MDNSRecord> goodbyes;
+        /** Querier of a unicast response */
+        bool unicast;
+        MDNSNativeSocket::Endpoint destination;
+
+        Pending()
+            : unicast(false)
+        { }
+    };
+
+    void run();
+    void handleQuery(const MDNSMessage &query, const MDNSNativeSocket::Endpoint &source, Clock::time_point now);
+    void appendRecords(const Instance &instance, std::uint32_t ttlOverride, std::vector<MDNSRecord> &records) const;
+    void send(const std::vector<MDNSRecord> &records, const MDNSNativeSocket::Endpoint &destination, bool unicast);
+
+    Options options_;
+    MDNSNativeSocket socket_;
+    std::thread thread_;
+    std::atomic<bool> running_;
+
+    mutable std::mutex mutex_;
+    std::map<std::string, Instance> instances_;
+    /** Lower case PTR name to lower case instance names */
+    std::map<std::string, std::set<std::string> > ptrIndex_;
+    std::multimap<Clock::time_point, Pending> pending_;
+    std::mt19937 random_;
+    Stats stats_;
+};
+
+} // namespace MDNS
+
+#endif /* MDNSNATIVERESPONDER_HPP_INCLUDED */
@@ -0,0 +1,252 @@
+/*
+ * MDNSNativeSocket.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include "MDNSNativeSocket.hpp"
+#include "MDNSPacket.hpp"
+#include <cerrno>
+#include <cstring>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/sock_diag.h>
+#endif
+
+namespace MDNS
+{
+
+namespace
+{
+
+void setError(std::string *error, const std::string &what)
+{
+    if (error)
+        *error = what + ": " + std::strerror(errno);
+}
+
+} // namespace
+
+MDNSNativeSocket::Endpoint::Endpoint(const std::string &address, std::uint16_t port)
+    : address(inet_addr(address.c_str()))
+    , port(port)
+{
+}
+
+std::string MDNSNativeSocket::Endpoint::toString() const
+{
+    in_addr addr;
+    addr.s_addr = address;
+    char buf[INET_ADDRSTRLEN] = { 0 };
+    inet_ntop(AF_INET, &addr, buf, sizeof(buf));
+    return std::string(buf) + ":" + std::to_string(port);
+}
+
+MDNSNativeSocket::MDNSNativeSocket()
+    : fd_(-1)
+    , accepted_(0)
+    , dropped_(0)
+{
+}
+
+MDNSNativeSocket::~MDNSNativeSocket()
+{
+    close();
+}
+
+bool MDNSNativeSocket::open(const Options &options, std::string *error)
+{
+    close();
+
+    fd_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd_ < 0)
+    {
+        setError(error, "socket failed");
+        return false;
+    }
+
+    const int on = 1;
+    setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+#ifdef SO_REUSEPORT
+    setsockopt(fd_, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on));
+#endif
+#ifdef SO_RXQ_OVFL
+    setsockopt(fd_, SOL_SOCKET, SO_RXQ_OVFL, &on, sizeof(on));
+#endif
+#ifdef IP_PKTINFO
+    setsockopt(fd_, IPPROTO_IP, IP_PKTINFO, &on, sizeof(on));
+#endif
+    if (options.receiveBufferSize > 0)
+        setsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &options.receiveBufferSize, sizeof(options.receiveBufferSize));
+
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(options.port);
+    addr.sin_addr.s_addr = inet_addr(options.bindAddress.c_str());
+    if (::bind(fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0)
+    {
+        setError(error, "bind failed");
+        close();
+        return false;
+    }
+
+    if (options.joinMulticast)
+    {
+        ip_mreq mreq;
+        mreq.imr_multiaddr.s_addr = inet_addr(MDNS_MULTICAST_ADDRESS);
+        mreq.imr_interface.s_addr = inet_addr(options.interfaceAddress.c_str());
+        if (setsockopt(fd_, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0)
+        {
+            setError(error, "IP_ADD_MEMBERSHIP failed");
+            close();
+            return false;
+        }
+        setsockopt(fd_, IPPROTO_IP, IP_MULTICAST_IF, &mreq.imr_interface, sizeof(mreq.imr_interface));
+        const unsigned char ttl = 255, loop = options.multicastLoop ? 1 : 0;
+        setsockopt(fd_, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+        setsockopt(fd_, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+    }
+    return true;
+}
+
+void MDNSNativeSocket::close()
+{
+    if (fd_ >= 0)
+    {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+MDNSNativeSocket::Endpoint MDNSNativeSocket::getLocalEndpoint() const
+{
+    Endpoint endpoint;
+    sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+    if (fd_ >= 0 && getsockname(fd_, reinterpret_cast<sockaddr *>(&addr), &len) == 0)
+    {
+        endpoint.address = addr.sin_addr.s_addr;
+        endpoint.port = ntohs(addr.sin_port);
+    }
+    return endpoint;
+}
+
+bool MDNSNativeSocket::setFilter(const MDNSSocketFilter &filter, std::string *error)
+{
+    if (filter.isEmpty())
+    {
+        // Detaching without a filter attached fails with ENOENT
+        MDNSSocketFilter::detach(fd_);
+        return true;
+    }
+    return MDNSSocketFilter::attach(fd_, filter.compile(MDNSSocketFilter::UDP_PAYLOAD_OFFSET), error);
+}
+
+bool MDNSNativeSocket::sendTo(const void *data, std::size_t size, const Endpoint &destination, std::string *error)
+{
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(destination.port);
+    addr.sin_addr.s_addr = destination.address;
+    if (::sendto(fd_, data, size, 0, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0)
+    {
+        setError(error, "sendto failed");
+        return false;
+    }
+    return true;
+}
+
+bool MDNSNativeSocket::receive(std::vector<std::uint8_t> &packet, Endpoint &source,
+                               std::chrono::milliseconds timeout, std::string *error,
+                               std::uint32_t *destinationAddress)
+{
+    pollfd pfd;
+    pfd.fd = fd_;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    const int ready = ::poll(&pfd, 1, static_cast<int>(timeout.count()));
+    if (ready <= 0)
+    {
+        if (ready < 0)
+            setError(error, "poll failed");
+        return false;
+    }
+
+    // Largest mDNS message is 9000 bytes (RFC 6762 section 17)
+    packet.resize(9000);
+    sockaddr_in addr;
+    iovec iov;
+    iov.iov_base = packet.data();
+    iov.iov_len = packet.size();
+    // Room for SO_RXQ_OVFL and IP_PKTINFO
+    char control[CMSG_SPACE(sizeof(std::uint32_t)) + CMSG_SPACE(64)];
+    msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_name = &addr;
+    msg.msg_namelen = sizeof(addr);
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    const ssize_t size = ::recvmsg(fd_, &msg, 0);
+    if (size < 0)
+    {
+        setError(error, "recvmsg failed");
+        return false;
+    }
+    packet.resize(static_cast<std::size_t>(size));
+    source.address = addr.sin_addr.s_addr;
+    source.port = ntohs(addr.sin_port);
+    ++accepted_;
+
+    if (destinationAddress)
+        *destinationAddress = 0;
+    for (cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg))
+    {
+#ifdef SO_RXQ_OVFL
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_RXQ_OVFL)
+        {
+            // Total number of packets the kernel dropped on this socket so far
+            std::uint32_t drops;
+            std::memcpy(&drops, CMSG_DATA(cmsg), sizeof(drops));
+            dropped_ = drops;
+        }
+#endif
+#ifdef IP_PKTINFO
+        if (cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_PKTINFO && destinationAddress)
+        {
+            in_pktinfo info;
+            std::memcpy(&info, CMSG_DATA(cmsg), sizeof(info));
+            *destinationAddress = info.ipi_addr.s_addr;
+        }
+#endif
+    }
+    return true;
+}
+
+MDNSNativeSocket::Stats MDNSNativeSocket::getStats() const
+{
+    Stats stats;
+    stats.accepted = accepted_;
+    stats.dropped = dropped_;
+#if defined(__linux__) && defined(SO_MEMINFO)
+    // Current drop count, SO_RXQ_OVFL only reports it with the next packet
+    std::uint32_t meminfo[SK_MEMINFO_VARS];
+    socklen_t length = sizeof(meminfo);
+    if (fd_ >= 0 && getsockopt(fd_, SOL_SOCKET, SO_MEMINFO, meminfo, &length) == 0 &&
+        length > SK_MEMINFO_DROPS * sizeof(std::uint32_t))
+        stats.dropped = meminfo[SK_MEMINFO_DROPS];
+#endif
+    return stats;
+}
+
+} // namespace MDNS
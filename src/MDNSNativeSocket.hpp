@@ -0,0 +1,148 @@
+/*
+ * MDNSNativeSocket.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef MDNSNATIVESOCKET_HPP_INCLUDED
+#define MDNSNATIVESOCKET_HPP_INCLUDED
+
+#include "MDNSPacket.hpp"
+#include "MDNSSocketFilter.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace MDNS
+{
+
+/**
+ * IPv4 UDP socket for daemon-free mDNS (POSIX only). Incoming packets can be
+ * filtered in the kernel with an MDNSSocketFilter, the socket counts
+ * accepted packets and packets dropped by the kernel.
+ */
+class MDNSNativeSocket
+{
+public:
+
+    struct Options
+    {
+        /** Local address to bind to, "0.0.0.0" for any */
+        std::string bindAddress;
+        /**
+         * MDNS_PORT on a network, 0 for an ephemeral port. Queries from other
+         * ports are legacy unicast queries (RFC 6762 section 6.7): responders
+         * ignore their QU bit and answer to the source port only, so the
+         * socket never receives multicast answers.
+         */
+        std::uint16_t port;
+        /** Join MDNS_MULTICAST_ADDRESS on interfaceAddress */
+        bool joinMulticast;
+        std::string interfaceAddress;
+        /** Receive own multicast packets */
+        bool multicastLoop;
+        /** SO_RCVBUF, 0 keeps the system default */
+        int receiveBufferSize;
+
+        Options()
+            : bindAddress("0.0.0.0")
+            , port(0)
+            , joinMulticast(false)
+            , interfaceAddress("0.0.0.0")
+            , multicastLoop(true)
+            , receiveBufferSize(0)
+        { }
+
+        /** MDNS_PORT on all interfaces and member of the mDNS group, for use on a network */
+        static Options multicast()
+        {
+            Options options;
+            options.port = MDNS_PORT;
+            options.joinMulticast = true;
+            return options;
+        }
+    };
+
+    struct Endpoint
+    {
+        /** In network byte order */
+        std::uint32_t address;
+        std::uint16_t port;
+
+        Endpoint()
+            : address(0), port(0)
+        { }
+
+        Endpoint(const std::string &address, std::uint16_t port);
+
+        std::string toString() const;
+    };
+
+    struct Stats
+    {
+        /** Packets received by the process */
+        std::uint64_t accepted;
+        /**
+         * Packets dropped by the kernel, filtered out or lost due to a full
+         * receive buffer (Linux only). Read with SO_MEMINFO when available,
+         * otherwise taken from the SO_RXQ_OVFL count of the last received
+         * packet, so drops after it are only counted once a later packet is
+         * received.
+         */
+        std::uint64_t dropped;
+
+        Stats()
+            : accepted(0), dropped(0)
+        { }
+    };
+
+    MDNSNativeSocket();
+    ~MDNSNativeSocket();
+
+    MDNSNativeSocket(const MDNSNativeSocket &) = delete;
+    MDNSNativeSocket & operator=(const MDNSNativeSocket &) = delete;
+
+    /** Returns false and sets error on failure */
+    bool open(const Options &options, std::string *error = 0);
+
+    void close();
+
+    bool isOpen() const { return fd_ >= 0; }
+
+    int getDescriptor() const { return fd_; }
+
+    /** Local endpoint after open, useful with ephemeral ports */
+    Endpoint getLocalEndpoint() const;
+
+    /**
+     * Attach compiled filter, an empty filter detaches. Packets already queued
+     * are not filtered.
+     */
+    bool setFilter(const MDNSSocketFilter &filter, std::string *error = 0);
+
+    bool sendTo(const void *data, std::size_t size, const Endpoint &destination, std::string *error = 0);
+
+    /**
+     * Wait up to timeout for a packet, returns false on timeout or error.
+     * destinationAddress receives the address the packet was sent to, in
+     * network byte order, to tell multicast from unicast packets (Linux only,
+     * 0 if unknown).
+     */
+    bool receive(std::vector<std::uint8_t> &packet, Endpoint &source,
+                 std::chrono::milliseconds timeout, std::string *error = 0,
+                 std::uint32_t *destinationAddress = 0);
+
+    Stats getStats() const;
+
+private:
+    int fd_;
+    std::atomic<std::uint64_t> accepted_;
+    std::atomic<std::uint64_t> dropped_;
+};
+
+} // namespace MDNS
+
+#endif /* MDNSNATIVESOCKET_HPP_INCLUDED */
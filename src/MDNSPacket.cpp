@@ -0,0 +1,443 @@
+/*
+ * MDNSPacket.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include "MDNSPacket.hpp"
+#include <cstring>
+
+namespace MDNS
+{
+
+namespace
+{
+
+char toLowerAscii(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+std::string toLowerAscii(const std::string &str)
+{
+    std::string result(str);
+    for (auto it = result.begin(), iend = result.end(); it != iend; ++it)
+        *it = toLowerAscii(*it);
+    return result;
+}
+
+std::string escapeLabel(const std::string &label)
+{
+    std::string result;
+    result.reserve(label.size());
+    for (auto it = label.begin(), iend = label.end(); it != iend; ++it)
+    {
+        if (*it == '.' || *it == '\\')
+            result += '\\';
+        result += *it;
+    }
+    return result;
+}
+
+class Writer
+{
+public:
+
+    void put8(std::uint8_t v) { buffer_ += static_cast<char>(v); }
+
+    void put16(std::uint16_t v)
+    {
+        put8(static_cast<std::uint8_t>(v >> 8));
+        put8(static_cast<std::uint8_t>(v));
+    }
+
+    void put32(std::uint32_t v)
+    {
+        put16(static_cast<std::uint16_t>(v >> 16));
+        put16(static_cast<std::uint16_t>(v));
+    }
+
+    void putName(const std::string &name)
+    {
+        const std::vector<std::string> labels = splitName(name);
+        for (std::size_t i = 0; i < labels.size(); ++i)
+        {
+            std::vector<std::string> suffix(labels.begin() + i, labels.end());
+            const std::string key = toLowerAscii(joinName(suffix));
+            auto it = offsets_.find(key);
+            if (it != offsets_.end())
+            {
+                put16(static_cast<std::uint16_t>(0xC000 | it->second));
+                return;
+            }
+            if (buffer_.size() < 0x3FFF)
+                offsets_[key] = static_cast<std::uint16_t>(buffer_.size());
+            const std::string &label = labels[i];
+            put8(static_cast<std::uint8_t>(label.size() > 63 ? 63 : label.size()));
+            buffer_.append(label, 0, 63);
+        }
+        put8(0);
+    }
+
+    std::size_t size() const { return buffer_.size(); }
+
+    void patch16(std::size_t offset, std::uint16_t v)
+    {
+        buffer_[offset] = static_cast<char>(v >> 8);
+        buffer_[offset + 1] = static_cast<char>(v);
+    }
+
+    void putRecord(const MDNSRecord &record)
+    {
+        putName(record.name);
+        put16(record.type);
+        put16(record.rclass);
+        put32(record.ttl);
+        const std::size_t lengthOffset = size();
+        put16(0);
+        const std::size_t start = size();
+        switch (record.type)
+        {
+            case MDNS_TYPE_PTR:
+                putName(record.target);
+                break;
+            case MDNS_TYPE_SRV:
+                put16(record.priority);
+                put16(record.weight);
+                put16(record.port);
+                putName(record.target);
+                break;
+            case MDNS_TYPE_TXT:
+                if (record.txt.empty())
+                    put8(0);
+                for (auto it = record.txt.begin(), iend = record.txt.end(); it != iend; ++it)
+                {
+                    const std::size_t len = it->size() > 255 ? 255 : it->size();
+                    put8(static_cast<std::uint8_t>(len));
+                    buffer_.append(*it, 0, len);
+                }
+                break;
+            case MDNS_TYPE_A:
+                buffer_.append(reinterpret_cast<const char *>(&record.address), 4);
+                break;
+            default:
+                buffer_ += record.data;
+                break;
+        }
+        patch16(lengthOffset, static_cast<std::uint16_t>(size() - start));
+    }
+
+    const std::string & getBuffer() const { return buffer_; }
+
+private:
+    std::string buffer_;
+    std::map<std::string, std::uint16_t> offsets_;
+};
+
+class Reader
+{
+public:
+
+    Reader(const std::uint8_t *data, std::size_t size)
+        : data_(data), size_(size), pos_(0)
+    { }
+
+    bool get8(std::uint8_t &v)
+    {
+        if (pos_ + 1 > size_)
+            return false;
+        v = data_[pos_++];
+        return true;
+    }
+
+    bool get16(std::uint16_t &v)
+    {
+        if (pos_ + 2 > size_)
+            return false;
+        v = static_cast<std::uint16_t>((data_[pos_] << 8) | data_[pos_ + 1]);
+        pos_ += 2;
+        return true;
+    }
+
+    bool get32(std::uint32_t &v)
+    {
+        std::uint16_t hi, lo;
+        if (!get16(hi) || !get16(lo))
+            return false;
+        v = (static_cast<std::uint32_t>(hi) << 16) | lo;
+        return true;
+    }
+
+    bool getName(std::string &name)
+    {
+        std::vector<std::string> labels;
+        std::size_t pos = pos_;
+        bool jumped = false;
+        int jumps = 0;
+        std::size_t total = 0;
+        for (;;)
+        {
+            if (pos >= size_)
+                return false;
+            const std::uint8_t len = data_[pos];
+            if ((len & 0xC0) == 0xC0)
+            {
+                if (pos + 1 >= size_ || ++jumps > 32)
+                    return false;
+                if (!jumped)
+                    pos_ = pos + 2;
+                jumped = true;
+                pos = static_cast<std::size_t>(((len & 0x3F) << 8) | data_[pos + 1]);
+                continue;
+            }
+            if (len & 0xC0)
+                return false;
+            if (len == 0)
+            {
+                if (!jumped)
+                    pos_ = pos + 1;
+                break;
+            }
+            if (pos + 1 + len > size_ || (total += len + 1) > 255)
+                return false;
+            labels.push_back(std::string(reinterpret_cast<const char *>(data_ + pos + 1), len));
+            pos += 1 + len;
+        }
+        name = joinName(labels);
+        return true;
+    }
+
+    bool getRecord(MDNSRecord &record)
+    {
+        std::uint16_t rdlength;
+        if (!getName(record.name) || !get16(record.type) || !get16(record.rclass) ||
+            !get32(record.ttl) || !get16(rdlength) || pos_ + rdlength > size_)
+            return false;
+        const std::size_t end = pos_ + rdlength;
+        switch (record.type)
+        {
+            case MDNS_TYPE_PTR:
+                if (!getName(record.target))
+                    return false;
+                break;
+            case MDNS_TYPE_SRV:
+                if (!get16(record.priority) || !get16(record.weight) || !get16(record.port) ||
+                    !getName(record.target))
+                    return false;
+                break;
+            case MDNS_TYPE_TXT:
+                while (pos_ < end)
+                {
+                    const std::uint8_t len = data_[pos_++];
+                    if (pos_ + len > end)
+                        return false;
+                    if (len > 0)
+                        record.txt.push_back(std::string(reinterpret_cast<const char *>(data_ + pos_), len));
+                    pos_ += len;
+                }
+                break;
+            case MDNS_TYPE_A:
+                if (rdlength != 4)
+                    return false;
+                std::memcpy(&record.address, data_ + pos_, 4);
+                break;
+            default:
+                record.data.assign(reinterpret_cast<const char *>(data_ + pos_), rdlength);
+                break;
+        }
+        pos_ = end;
+        return true;
+    }
+
+private:
+    const std::uint8_t *data_;
+    std::size_t size_;
+    std::size_t pos_;
+};
+
+} // namespace
+
+MDNSRecord MDNSRecord::makePtr(const std::string &name, const std::string &target, std::uint32_t ttl)
+{
+    MDNSRecord record;
+    record.name = name;
+    record.type = MDNS_TYPE_PTR;
+    record.ttl = ttl;
+    record.target = target;
+    return record;
+}
+
+MDNSRecord MDNSRecord::makeSrv(const std::string &name, const std::string &host, std::uint16_t port,
+                               std::uint32_t ttl, std::uint16_t priority, std::uint16_t weight)
+{
+    MDNSRecord record;
+    record.name = name;
+    record.type = MDNS_TYPE_SRV;
+    record.rclass = MDNS_CLASS_IN | MDNS_CLASS_CACHE_FLUSH;
+    record.ttl = ttl;
+    record.target = host;
+    record.port = port;
+    record.priority = priority;
+    record.weight = weight;
+    return record;
+}
+
+MDNSRecord MDNSRecord::makeTxt(const std::string &name, const std::vector<std::string> &txt, std::uint32_t ttl)
+{
+    MDNSRecord record;
+    record.name = name;
+    record.type = MDNS_TYPE_TXT;
+    record.rclass = MDNS_CLASS_IN | MDNS_CLASS_CACHE_FLUSH;
+    record.ttl = ttl;
+    record.txt = txt;
+    return record;
+}
+
+MDNSRecord MDNSRecord::makeA(const std::string &name, std::uint32_t address, std::uint32_t ttl)
+{
+    MDNSRecord record;
+    record.name = name;
+    record.type = MDNS_TYPE_A;
+    record.rclass = MDNS_CLASS_IN | MDNS_CLASS_CACHE_FLUSH;
+    record.ttl = ttl;
+    record.address = address;
+    return record;
+}
+
+std::string encodeMessage(const MDNSMessage &message)
+{
+    Writer writer;
+    writer.put16(message.id);
+    writer.put16(message.flags);
+    writer.put16(static_cast<std::uint16_t>(message.questions.size()));
+    writer.put16(static_cast<std::uint16_t>(message.answers.size()));
+    writer.put16(static_cast<std::uint16_t>(message.authorities.size()));
+    writer.put16(static_cast<std::uint16_t>(message.additionals.size()));
+    for (auto it = message.questions.begin(), iend = message.questions.end(); it != iend; ++it)
+    {
+        writer.putName(it->name);
+        writer.put16(it->type);
+        writer.put16(it->qclass);
+    }
+    for (auto it = message.answers.begin(), iend = message.answers.end(); it != iend; ++it)
+        writer.putRecord(*it);
+    for (auto it = message.authorities.begin(), iend = message.authorities.end(); it != iend; ++it)
+        writer.putRecord(*it);
+    for (auto it = message.additionals.begin(), iend = message.additionals.end(); it != iend; ++it)
+        writer.putRecord(*it);
+    return writer.getBuffer();
+}
+
+bool decodeMessage(const void *data, std::size_t size, MDNSMessage &message, std::string *error)
+{
+    Reader reader(static_cast<const std::uint8_t *>(data), size);
+    std::uint16_t qdcount, ancount, nscount, arcount;
+    message = MDNSMessage();
+    if (!reader.get16(message.id) || !reader.get16(message.flags) ||
+        !reader.get16(qdcount) || !reader.get16(ancount) || !reader.get16(nscount) || !reader.get16(arcount))
+    {
+        if (error)
+            *error = "truncated header";
+        return false;
+    }
+    for (std::uint16_t i = 0; i < qdcount; ++i)
+    {
+        MDNSQuestion question;
+        if (!reader.getName(question.name) || !reader.get16(question.type) || !reader.get16(question.qclass))
+        {
+            if (error)
+                *error = "malformed question";
+            return false;
+        }
+        message.questions.push_back(question);
+    }
+    std::vector<MDNSRecord> *sections[] = { &message.answers, &message.authorities, &message.additionals };
+    const std::uint16_t counts[] = { ancount, nscount, arcount };
+    for (int s = 0; s < 3; ++s)
+    {
+        for (std::uint16_t i = 0; i < counts[s]; ++i)
+        {
+            MDNSRecord record;
+            if (!reader.getRecord(record))
+            {
+                if (error)
+                    *error = "malformed resource record";
+                return false;
+            }
+            sections[s]->push_back(record);
+        }
+    }
+    return true;
+}
+
+std::vector<std::string> splitName(const std::string &name)
+{
+    std::vector<std::string> labels;
+    std::string label;
+    for (std::size_t i = 0; i < name.size(); ++i)
+    {
+        const char c = name[i];
+        if (c == '\\' && i + 1 < name.size())
+            label += name[++i];
+        else if (c == '.')
+        {
+            if (!label.empty())
+                labels.push_back(label);
+            label.clear();
+        }
+        else
+            label += c;
+    }
+    if (!label.empty())
+        labels.push_back(label);
+    return labels;
+}
+
+std::string joinName(const std::vector<std::string> &labels)
+{
+    std::string name;
+    for (auto it = labels.begin(), iend = labels.end(); it != iend; ++it)
+    {
+        if (!name.empty())
+            name += '.';
+        name += escapeLabel(*it);
+    }
+    return name;
+}
+
+std::string makeInstanceName(const std::string &instance, const std::string &type, const std::string &domain)
+{
+    return escapeLabel(instance) + "." + type + "." + (domain.empty() ? std::string("local") : domain);
+}
+
+std::string toWireName(const std::string &name)
+{
+    std::string wire;
+    const std::vector<std::string> labels = splitName(name);
+    for (auto it = labels.begin(), iend = labels.end(); it != iend; ++it)
+    {
+        wire += static_cast<char>(it->size() > 63 ? 63 : it->size());
+        wire.append(*it, 0, 63);
+    }
+    wire += '\0';
+    return wire;
+}
+
+std::string toLowerName(const std::string &name)
+{
+    return toLowerAscii(name);
+}
+
+bool equalNames(const std::string &a, const std::string &b)
+{
+    if (a.size() != b.size())
+        return false;
+    for (std::size_t i = 0; i < a.size(); ++i)
+    {
+        if (toLowerAscii(a[i]) != toLowerAscii(b[i]))
+            return false;
+    }
+    return true;
+}
+
+} // namespace MDNS
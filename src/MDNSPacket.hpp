@@ -0,0 +1,140 @@
+/*
+ * MDNSPacket.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef MDNSPACKET_HPP_INCLUDED
+#define MDNSPACKET_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * Minimal DNS message encoder and decoder for the daemon-free code paths
+ * (socket filter, loopback harness). Names are dotted strings, dots and
+ * backslashes inside labels are escaped with a backslash like in RFC 6763
+ * section 4.3.
+ */
+
+namespace MDNS
+{
+
+enum MDNSRecordType
+{
+    MDNS_TYPE_A = 1,
+    MDNS_TYPE_PTR = 12,
+    MDNS_TYPE_TXT = 16,
+    MDNS_TYPE_AAAA = 28,
+    MDNS_TYPE_SRV = 33,
+    MDNS_TYPE_NSEC = 47,
+    MDNS_TYPE_ANY = 255
+};
+
+const std::uint16_t MDNS_CLASS_IN = 1;
+/** Top bit of the class: unicast-response in questions, cache-flush in records */
+const std::uint16_t MDNS_CLASS_QU = 0x8000;
+const std::uint16_t MDNS_CLASS_CACHE_FLUSH = 0x8000;
+
+const std::uint16_t MDNS_FLAG_RESPONSE = 0x8000;
+const std::uint16_t MDNS_FLAG_AUTHORITATIVE = 0x0400;
+const std::uint16_t MDNS_FLAG_TRUNCATED = 0x0200;
+
+const std::uint16_t MDNS_PORT = 5353;
+const char * const MDNS_MULTICAST_ADDRESS = "224.0.0.251";
+
+struct MDNSQuestion
+{
+    std::string name;
+    std::uint16_t type;
+    std::uint16_t qclass;
+
+    MDNSQuestion(const std::string &name = std::string(), std::uint16_t type = MDNS_TYPE_PTR,
+                 std::uint16_t qclass = MDNS_CLASS_IN)
+        : name(name), type(type), qclass(qclass)
+    { }
+
+    bool isUnicastResponse() const { return (qclass & MDNS_CLASS_QU) != 0; }
+};
+
+struct MDNSRecord
+{
+    std::string name;
+    std::uint16_t type;
+    std::uint16_t rclass;
+    std::uint32_t ttl;
+
+    /** PTR target or SRV target host */
+    std::string target;
+    /** SRV */
+    std::uint16_t priority;
+    std::uint16_t weight;
+    std::uint16_t port;
+    /** TXT strings */
+    std::vector<std::string> txt;
+    /** A, in network byte order */
+    std::uint32_t address;
+    /** RDATA of other types, uninterpreted */
+    std::string data;
+
+    MDNSRecord()
+        : type(0), rclass(MDNS_CLASS_IN), ttl(0), priority(0), weight(0), port(0), address(0)
+    { }
+
+    static MDNSRecord makePtr(const std::string &name, const std::string &target, std::uint32_t ttl);
+    static MDNSRecord makeSrv(const std::string &name, const std::string &host, std::uint16_t port,
+                              std::uint32_t ttl, std::uint16_t priority = 0, std::uint16_t weight = 0);
+    static MDNSRecord makeTxt(const std::string &name, const std::vector<std::string> &txt, std::uint32_t ttl);
+    static MDNSRecord makeA(const std::string &name, std::uint32_t address, std::uint32_t ttl);
+};
+
+struct MDNSMessage
+{
+    std::uint16_t id;
+    std::uint16_t flags;
+    std::vector<MDNSQuestion> questions;
+    std::vector<MDNSRecord> answers;
+    std::vector<MDNSRecord> authorities;
+    std::vector<MDNSRecord> additionals;
+
+    MDNSMessage()
+        : id(0), flags(0)
+    { }
+
+    bool isResponse() const { return (flags & MDNS_FLAG_RESPONSE) != 0; }
+};
+
+/**
+ * Encode message with name compression.
+ */
+std::string encodeMessage(const MDNSMessage &message);
+
+/**
+ * Decode message, returns false and sets error on malformed input.
+ */
+bool decodeMessage(const void *data, std::size_t size, MDNSMessage &message, std::string *error = 0);
+
+/** Split escaped dotted name into labels */
+std::vector<std::string> splitName(const std::string &name);
+
+/** Join labels into escaped dotted name */
+std::string joinName(const std::vector<std::string> &labels);
+
+/** Escaped dotted name of a service instance, e.g. "My\.Service._http._tcp.local" */
+std::string makeInstanceName(const std::string &instance, const std::string &type, const std::string &domain);
+
+/** Uncompressed wire format of a dotted name including the root label */
+std::string toWireName(const std::string &name);
+
+/** ASCII lower case form of a dotted name, e.g. for use as map key */
+std::string toLowerName(const std::string &name);
+
+/** Case-insensitive (ASCII) comparison of dotted names */
+bool equalNames(const std::string &a, const std::string &b);
+
+} // namespace MDNS
+
+#endif /* MDNSPACKET_HPP_INCLUDED */
@@ -0,0 +1,324 @@
+/*
+ * MDNSSendScheduler.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include "MDNSSendScheduler.hpp"
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+
+namespace MDNS
+{
+
+const char * toString(MDNSSendPriority priority)
+{
+    switch (priority)
+    {
+        case MDNS_SEND_GOODBYE: return "goodbye";
+        case MDNS_SEND_PROBE: return "probe";
+        case MDNS_SEND_QUERY: return "query";
+        default: return "unknown";
+    }
+}
+
+void MDNSSendScheduler::Bucket::refill(Clock::time_point now)
+{
+    if (now <= lastRefill)
+        return;
+    const double elapsed = std::chrono::duration<double>(now - lastRefill).count();
+    tokens = std::min(limit.burst, tokens + elapsed * limit.recordsPerSecond);
+    lastRefill = now;
+}
+
+const MDNSSendScheduler::Operation * MDNSSendScheduler::Bucket::front() const
+{
+    for (int i = 0; i < MDNS_SEND_NUM_PRIORITIES; ++i)
+    {
+        if (!queues[i].empty())
+            return &queues[i].front();
+    }
+    return 0;
+}
+
+MDNSSendScheduler::MDNSSendScheduler(MDNSManager &manager, const RateLimit &defaultLimit)
+    : manager_(manager)
+    , defaultLimit_(defaultLimit)
+    , queued_(0)
+    , inFlight_(0)
+    , stopping_(false)
+{
+    checkRateLimit(defaultLimit);
+    thread_ = std::thread(&MDNSSendScheduler::run, this);
+}
+
+MDNSSendScheduler::~MDNSSendScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wakeup_.notify_all();
+    thread_.join();
+
+    // Goodbyes are sent without rate limit, everything else is dropped
+    std::vector<Operation> goodbyes;
+    for (auto it = buckets_.begin(), iend = buckets_.end(); it != iend; ++it)
+    {
+        std::deque<Operation> &queue = it->second.queues[MDNS_SEND_GOODBYE];
+        goodbyes.insert(goodbyes.end(), queue.begin(), queue.end());
+    }
+    execute(goodbyes);
+}
+
+void MDNSSendScheduler::setRateLimit(MDNSInterfaceIndex interfaceIndex, const RateLimit &limit)
+{
+    checkRateLimit(limit);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Bucket &bucket = getBucket(interfaceIndex, Clock::now());
+        bucket.limit = limit;
+        bucket.tokens = std::min(bucket.tokens, limit.burst);
+    }
+    wakeup_.notify_all();
+}
+
+void MDNSSendScheduler::setErrorHandler(const ErrorHandler &handler)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    errorHandler_ = handler;
+}
+
+void MDNSSendScheduler::checkRateLimit(const RateLimit &limit)
+{
+    // Also rejects NaN, the time until the bucket is refilled is infinite otherwise
+    if (!(limit.recordsPerSecond > 0.0))
+        throw std::invalid_argument("MDNSSendScheduler: recordsPerSecond must be positive");
+    // Operations cost at most burst, the limit would be disabled otherwise
+    if (!(limit.burst > 0.0))
+        throw std::invalid_argument("MDNSSendScheduler: burst must be positive");
+}
+
+unsigned int MDNSSendScheduler::getRecordCount(const MDNSService &service)
+{
+    // PTR, SRV and TXT records plus one PTR record per subtype
+    return 3 + static_cast<unsigned int>(service.getSubtypes().size());
+}
+
+void MDNSSendScheduler::registerService(MDNSService &service, MDNSSendPriority priority)
+{
+    Operation op;
+    op.priority = priority;
+    op.service = &service;
+    op.isRegistration = true;
+    op.cost = getRecordCount(service);
+    op.action = [this, &service]() { manager_.registerService(service); };
+    enqueue(service.getInterfaceIndex(), op);
+}
+
+void MDNSSendScheduler::unregisterService(MDNSService &service)
+{
+    if (cancelPendingRegistration(service))
+        return;
+
+    Operation op;
+    op.priority = MDNS_SEND_GOODBYE;
+    op.service = 0;
+    op.isRegistration = false;
+    op.cost = getRecordCount(service);
+    // The goodbye is sent later, keep a copy, it carries the id of the registration
+    op.action = [this, service]() mutable { manager_.unregisterService(service); };
+    enqueue(service.getInterfaceIndex(), op);
+}
+
+void MDNSSendScheduler::registerServiceBrowser(const MDNSServiceBrowser::Ptr & browser,
+                                               MDNSInterfaceIndex interfaceIndex,
+                                               const std::string &type,
+                                               const std::vector<std::string> *subtypes,
+                                               const std::string &domain)
+{
+    Operation op;
+    op.priority = MDNS_SEND_QUERY;
+    op.service = 0;
+    op.isRegistration = false;
+    op.cost = 1 + (subtypes ? static_cast<unsigned int>(subtypes->size()) : 0);
+
+    const bool hasSubtypes = subtypes != 0;
+    const std::vector<std::string> subtypesCopy = hasSubtypes ? *subtypes : std::vector<std::string>();
+    op.action = [this, browser, interfaceIndex, type, hasSubtypes, subtypesCopy, domain]()
+    {
+        manager_.registerServiceBrowser(browser, interfaceIndex, type,
+                                        hasSubtypes ? &subtypesCopy : 0, domain);
+    };
+    enqueue(interfaceIndex, op);
+}
+
+void MDNSSendScheduler::flush()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    drained_.wait(lock, [this]() { return stopping_ || (queued_ == 0 && inFlight_ == 0); });
+}
+
+std::size_t MDNSSendScheduler::getQueueSize() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queued_;
+}
+
+MDNSSendScheduler::Stats MDNSSendScheduler::getStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats = stats_;
+    for (auto it = buckets_.begin(), iend = buckets_.end(); it != iend; ++it)
+    {
+        for (int i = 0; i < MDNS_SEND_NUM_PRIORITIES; ++i)
+            stats.priorities[i].queued += it->second.queues[i].size();
+    }
+    return stats;
+}
+
+MDNSSendScheduler::Bucket & MDNSSendScheduler::getBucket(MDNSInterfaceIndex interfaceIndex, Clock::time_point now)
+{
+    auto it = buckets_.find(interfaceIndex);
+    if (it == buckets_.end())
+        it = buckets_.insert(std::make_pair(interfaceIndex, Bucket(defaultLimit_, now))).first;
+    return it->second;
+}
+
+void MDNSSendScheduler::enqueue(MDNSInterfaceIndex interfaceIndex, Operation op)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        op.enqueued = Clock::now();
+        getBucket(interfaceIndex, op.enqueued).queues[op.priority].push_back(op);
+        ++stats_.priorities[op.priority].enqueued;
+        ++queued_;
+    }
+    wakeup_.notify_all();
+}
+
+bool MDNSSendScheduler::cancelPendingRegistration(MDNSService &service)
+{
+    bool cancelled = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto it = buckets_.begin(), iend = buckets_.end(); it != iend; ++it)
+        {
+            for (int i = 0; i < MDNS_SEND_NUM_PRIORITIES; ++i)
+            {
+                std::deque<Operation> &queue = it->second.queues[i];
+                for (auto op = queue.begin(); op != queue.end(); )
+                {
+                    if (op->service == &service && op->isRegistration)
+                    {
+                        op = queue.erase(op);
+                        ++stats_.priorities[i].cancelled;
+                        --queued_;
+                        cancelled = true;
+                    }
+                    else
+                        ++op;
+                }
+            }
+        }
+    }
+    if (cancelled)
+        drained_.notify_all();
+    return cancelled;
+}
+
+void MDNSSendScheduler::run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    std::vector<Operation> batch;
+
+    while (!stopping_)
+    {
+        const Clock::time_point now = Clock::now();
+        Clock::time_point nextWakeup = Clock::time_point::max();
+
+        for (auto it = buckets_.begin(), iend = buckets_.end(); it != iend; ++it)
+        {
+            Bucket &bucket = it->second;
+            bucket.refill(now);
+
+            // Strict priority: lower classes wait until all higher ones of the
+            // same interface are sent. Operations that are larger than the bucket
+            // are sent when it is full.
+            while (const Operation *op = bucket.front())
+            {
+                const double cost = std::min<double>(op->cost, bucket.limit.burst);
+                if (bucket.tokens < cost)
+                {
+                    const double missing = cost - bucket.tokens;
+                    const Clock::time_point ready = now +
+                        std::chrono::duration_cast<Clock::duration>(
+                            std::chrono::duration<double>(missing / bucket.limit.recordsPerSecond));
+                    nextWakeup = std::min(nextWakeup, ready);
+                    break;
+                }
+                bucket.tokens -= cost;
+
+                std::deque<Operation> &queue = bucket.queues[op->priority];
+                batch.push_back(queue.front());
+                queue.pop_front();
+            }
+        }
+
+        if (!batch.empty())
+        {
+            for (auto op = batch.begin(), opend = batch.end(); op != opend; ++op)
+            {
+                PriorityStats &ps = stats_.priorities[op->priority];
+                const std::chrono::microseconds delay =
+                    std::chrono::duration_cast<std::chrono::microseconds>(now - op->enqueued);
+                ++ps.dispatched;
+                ps.records += op->cost;
+                ps.totalDelay += delay;
+                ps.maxDelay = std::max(ps.maxDelay, delay);
+            }
+            ++stats_.batches;
+            queued_ -= batch.size();
+            inFlight_ = batch.size();
+
+            lock.unlock();
+            execute(batch);
+            batch.clear();
+            lock.lock();
+
+            inFlight_ = 0;
+            drained_.notify_all();
+            continue;
+        }
+
+        if (nextWakeup == Clock::time_point::max())
+            wakeup_.wait(lock);
+        else
+            wakeup_.wait_until(lock, nextWakeup);
+    }
+    drained_.notify_all();
+}
+
+void MDNSSendScheduler::execute(std::vector<Operation> &batch)
+{
+    for (auto op = batch.begin(), opend = batch.end(); op != opend; ++op)
+    {
+        try
+        {
+            op->action();
+        }
+        catch (std::exception &e)
+        {
+            ErrorHandler handler;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                handler = errorHandler_;
+            }
+            if (handler)
+                handler(std::string("MDNSSendScheduler: ") + toString(op->priority) + " failed: " + e.what());
+        }
+    }
+}
+
+} // namespace MDNS
@@ -0,0 +1,222 @@
+/*
+ * MDNSSendScheduler.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef MDNSSENDSCHEDULER_HPP_INCLUDED
+#define MDNSSENDSCHEDULER_HPP_INCLUDED
+
+#include "MDNSManager.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace MDNS
+{
+
+/**
+ * Priority classes of the send scheduler, highest priority first.
+ *
+ * The classes order the MDNSManager calls, not the packets: the daemon sends
+ * the goodbye of an unregistered service, the probes and announcements of a
+ * registered one and the queries of a new browser on its own schedule, and
+ * its refresh queries are not scheduled at all.
+ */
+enum MDNSSendPriority
+{
+    /** unregisterService */
+    MDNS_SEND_GOODBYE = 0,
+    /** registerService, probing and announcing */
+    MDNS_SEND_PROBE,
+    /** registerServiceBrowser, initial queries */
+    MDNS_SEND_QUERY,
+    MDNS_SEND_NUM_PRIORITIES
+};
+
+const char * toString(MDNSSendPriority priority);
+
+/**
+ * Rate limited front-end for the register/unregister/browse calls of MDNSManager.
+ *
+ * Every operation is charged with the number of resource records the backend
+ * will send for it (PTR, SRV, TXT and one PTR per subtype) against a token bucket
+ * of the interface the operation is bound to. Pending operations are dispatched
+ * strictly by priority within an interface; all operations that fit into the
+ * bucket are dispatched back-to-back, so that the daemon can aggregate their
+ * records into shared packets.
+ *
+ * Services are passed by reference like to MDNSManager and must stay alive until
+ * they are unregistered. Unregistering copies the service, it may be destroyed
+ * right after unregisterService() returns.
+ */
+class MDNSSendScheduler
+{
+public:
+
+    typedef std::chrono::steady_clock Clock;
+    typedef std::function<void (const std::string &errorMsg)> ErrorHandler;
+
+    /** recordsPerSecond and burst must be positive, std::invalid_argument is thrown otherwise */
+    struct RateLimit
+    {
+        /** Sustained rate in records per second */
+        double recordsPerSecond;
+        /** Bucket size in records */
+        double burst;
+
+        RateLimit(double recordsPerSecond = 50.0, double burst = 25.0)
+            : recordsPerSecond(recordsPerSecond), burst(burst)
+        { }
+    };
+
+    struct PriorityStats
+    {
+        std::uint64_t enqueued;
+        std::uint64_t dispatched;
+        std::uint64_t cancelled;
+        std::uint64_t records;
+        std::size_t queued;
+        /** Accumulated and maximal time between enqueue and dispatch */
+        std::chrono::microseconds totalDelay;
+        std::chrono::microseconds maxDelay;
+
+        PriorityStats()
+            : enqueued(0), dispatched(0), cancelled(0), records(0), queued(0),
+              totalDelay(0), maxDelay(0)
+        { }
+
+        std::chrono::microseconds getAverageDelay() const
+        {
+            return std::chrono::microseconds(dispatched ? totalDelay.count() / static_cast<std::int64_t>(dispatched) : 0);
+        }
+    };
+
+    struct Stats
+    {
+        PriorityStats priorities[MDNS_SEND_NUM_PRIORITIES];
+        /** Number of wakeups that dispatched at least one operation */
+        std::uint64_t batches;
+
+        Stats() : batches(0) { }
+    };
+
+    MDNSSendScheduler(MDNSManager &manager, const RateLimit &defaultLimit = RateLimit());
+
+    /**
+     * Stops the scheduler, pending goodbyes are still sent, all other
+     * pending operations are dropped.
+     */
+    ~MDNSSendScheduler();
+
+    /**
+     * Set rate limit for the specified interface, MDNS_IF_ANY is used for
+     * services that are registered on all interfaces.
+     */
+    void setRateLimit(MDNSInterfaceIndex interfaceIndex, const RateLimit &limit);
+
+    void setErrorHandler(const ErrorHandler &handler);
+
+    void registerService(MDNSService &service, MDNSSendPriority priority = MDNS_SEND_PROBE);
+
+    /**
+     * Unregister service. If the registration of the service is still pending
+     * it is cancelled and no goodbye is sent.
+     */
+    void unregisterService(MDNSService &service);
+
+    void registerServiceBrowser(const MDNSServiceBrowser::Ptr & browser,
+                                MDNSInterfaceIndex interfaceIndex,
+                                const std::string &type,
+                                const std::vector<std::string> *subtypes,
+                                const std::string &domain);
+
+    void registerServiceBrowser(const MDNSServiceBrowser::Ptr & browser,
+                                MDNSInterfaceIndex interfaceIndex,
+                                const std::string &type,
+                                const std::string &domain)
+    {
+        registerServiceBrowser(browser, interfaceIndex, type, 0, domain);
+    }
+
+    void registerServiceBrowser(const MDNSServiceBrowser::Ptr & browser,
+                                MDNSInterfaceIndex interfaceIndex,
+                                const std::string &type,
+                                const std::vector<std::string> &subtypes,
+                                const std::string &domain)
+    {
+        registerServiceBrowser(browser, interfaceIndex, type, &subtypes, domain);
+    }
+
+    /**
+     * Block until all pending operations are dispatched.
+     */
+    void flush();
+
+    std::size_t getQueueSize() const;
+
+    Stats getStats() const;
+
+private:
+
+    struct Operation
+    {
+        MDNSSendPriority priority;
+        /** Registered service, used to cancel pending registrations only */
+        MDNSService *service;
+        bool isRegistration;
+        unsigned int cost;
+        Clock::time_point enqueued;
+        std::function<void ()> action;
+    };
+
+    struct Bucket
+    {
+        RateLimit limit;
+        double tokens;
+        Clock::time_point lastRefill;
+        std::deque<Operation> queues[MDNS_SEND_NUM_PRIORITIES];
+
+        Bucket(const RateLimit &limit, Clock::time_point now)
+            : limit(limit), tokens(limit.burst), lastRefill(now)
+        { }
+
+        void refill(Clock::time_point now);
+        const Operation * front() const;
+        bool isEmpty() const { return front() == 0; }
+    };
+
+    static unsigned int getRecordCount(const MDNSService &service);
+    static void checkRateLimit(const RateLimit &limit);
+
+    Bucket & getBucket(MDNSInterfaceIndex interfaceIndex, Clock::time_point now);
+    void enqueue(MDNSInterfaceIndex interfaceIndex, Operation op);
+    bool cancelPendingRegistration(MDNSService &service);
+    void run();
+    void execute(std::vector<Operation> &batch);
+
+    MDNSManager &manager_;
+    RateLimit defaultLimit_;
+    ErrorHandler errorHandler_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wakeup_;
+    std::condition_variable drained_;
+    std::map<MDNSInterfaceIndex, Bucket> buckets_;
+    std::size_t queued_;
+    std::size_t inFlight_;
+    bool stopping_;
+    Stats stats_;
+    std::thread thread_;
+};
+
+} // namespace MDNS
+
+#endif /* MDNSSENDSCHEDULER_HPP_INCLUDED */
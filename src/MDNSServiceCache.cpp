@@ -0,0 +1,329 @@
+/*
+ * MDNSServiceCache.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include "MDNSServiceCache.hpp"
+#include <sstream>
+
+namespace MDNS
+{
+
+namespace
+{
+
+std::size_t getHeapBytes(const std::string &str)
+{
+    // Strings stored in the small string buffer of the object own no heap memory
+    const char *data = str.data();
+    const char *object = reinterpret_cast<const char *>(&str);
+    if (data >= object && data < object + sizeof(str))
+        return 0;
+    return str.capacity() + 1;
+}
+
+std::size_t getHeapBytes(const std::vector<std::string> &strings)
+{
+    std::size_t bytes = strings.capacity() * sizeof(std::string);
+    for (auto it = strings.begin(), iend = strings.end(); it != iend; ++it)
+        bytes += getHeapBytes(*it);
+    return bytes;
+}
+
+// Per entry container overhead besides the key and the entry: hash map node
+// (next pointer and cached hash), one bucket pointer and a doubly linked list node
+const std::size_t CONTAINER_OVERHEAD = 2 * sizeof(void *) + sizeof(void *) + 3 * sizeof(void *);
+
+} // namespace
+
+// MDNSCacheBudget
+
+void MDNSCacheBudget::setLimit(std::size_t limitBytes)
+{
+    limit_ = limitBytes;
+    enforce();
+}
+
+void MDNSCacheBudget::attach(const std::shared_ptr<MDNSCachingBrowser> &cache)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    caches_.push_back(cache);
+}
+
+void MDNSCacheBudget::enforce()
+{
+    // Lock order is always budget before cache
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (used_.load() > limit_.load())
+    {
+        std::shared_ptr<MDNSCachingBrowser> victim;
+        std::size_t victimBytes = 0;
+        for (auto it = caches_.begin(); it != caches_.end(); )
+        {
+            std::shared_ptr<MDNSCachingBrowser> cache = it->lock();
+            if (!cache)
+            {
+                it = caches_.erase(it);
+                continue;
+            }
+            const std::size_t bytes = cache->getUsedBytes();
+            if (bytes > victimBytes)
+            {
+                victim = cache;
+                victimBytes = bytes;
+            }
+            ++it;
+        }
+        if (!victim || !victim->evictOne())
+            break;
+        ++evictions_;
+    }
+}
+
+// MDNSCachingBrowser
+
+MDNSCachingBrowser::Ptr MDNSCachingBrowser::create(std::size_t limitBytes,
+                                                   const MDNSCacheBudget::Ptr &globalBudget,
+                                                   const MDNSServiceBrowser::Ptr &downstream,
+                                                   MDNSEvictionPolicy policy)
+{
+    Ptr cache(new MDNSCachingBrowser(limitBytes, globalBudget, downstream, policy));
+    if (globalBudget)
+        globalBudget->attach(cache);
+    return cache;
+}
+
+MDNSCachingBrowser::MDNSCachingBrowser(std::size_t limitBytes, const MDNSCacheBudget::Ptr &globalBudget,
+                                       const MDNSServiceBrowser::Ptr &downstream, MDNSEvictionPolicy policy)
+    : globalBudget_(globalBudget)
+    , downstream_(downstream)
+    , policy_(policy)
+    , limit_(limitBytes)
+    , bytes_(0)
+    , evictedHistorySize_(1024)
+{
+}
+
+MDNSCachingBrowser::~MDNSCachingBrowser()
+{
+    if (globalBudget_)
+        globalBudget_->remove(bytes_);
+}
+
+void MDNSCachingBrowser::setResolveHandler(const ResolveHandler &handler)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    resolveHandler_ = handler;
+}
+
+void MDNSCachingBrowser::setLimit(std::size_t limitBytes)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    limit_ = limitBytes;
+    evictOverLimit();
+}
+
+void MDNSCachingBrowser::setEvictedHistorySize(std::size_t size)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    evictedHistorySize_ = size;
+    while (evictedOrder_.size() > evictedHistorySize_)
+        forgetEvicted(*evictedOrder_.front());
+}
+
+std::size_t MDNSCachingBrowser::getServiceBytes(const MDNSService &service)
+{
+    return sizeof(MDNSService) +
+        getHeapBytes(service.getName()) +
+        getHeapBytes(service.getType()) +
+        getHeapBytes(service.getDomain()) +
+        getHeapBytes(service.getHost()) +
+        getHeapBytes(service.getTxtRecords()) +
+        getHeapBytes(service.getSubtypes());
+}
+
+std::string MDNSCachingBrowser::makeKey(const std::string &name, const std::string &type,
+                                        const std::string &domain, MDNSInterfaceIndex interfaceIndex)
+{
+    std::ostringstream key;
+    key << name << '\0' << type << '\0' << domain << '\0' << interfaceIndex;
+    return key.str();
+}
+
+bool MDNSCachingBrowser::lookup(const std::string &name, const std::string &type, const std::string &domain,
+                                MDNSInterfaceIndex interfaceIndex, MDNSService &service)
+{
+    const std::string key = makeKey(name, type, domain, interfaceIndex);
+    ResolveHandler handler;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        if (it != entries_.end())
+        {
+            ++stats_.hits;
+            touch(it->second);
+            service = it->second.service;
+            return true;
+        }
+        ++stats_.misses;
+        if (!forgetEvicted(key))
+            return false;
+        ++stats_.reresolves;
+        handler = resolveHandler_;
+    }
+    if (handler)
+        handler(name, type, domain, interfaceIndex);
+    return false;
+}
+
+std::vector<MDNSService> MDNSCachingBrowser::getServices() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<MDNSService> services;
+    services.reserve(entries_.size());
+    for (auto it = lru_.begin(), iend = lru_.end(); it != iend; ++it)
+        services.push_back((*it)->second.service);
+    return services;
+}
+
+MDNSCachingBrowser::Stats MDNSCachingBrowser::getStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats = stats_;
+    stats.entries = entries_.size();
+    stats.bytes = bytes_;
+    stats.limit = limit_;
+    return stats;
+}
+
+void MDNSCachingBrowser::onNewService(const MDNSService &service)
+{
+    const std::string key = makeKey(service.getName(), service.getType(), service.getDomain(), service.getInterfaceIndex());
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        if (it == entries_.end())
+        {
+            it = entries_.insert(std::make_pair(key, Entry())).first;
+            lru_.push_front(&*it);
+            it->second.lruPos = lru_.begin();
+            it->second.bytes = 0;
+            ++stats_.inserts;
+        }
+        else
+        {
+            if (policy_ == MDNS_EVICT_LRU)
+                touch(it->second);
+            ++stats_.updates;
+        }
+
+        Entry &entry = it->second;
+        entry.service = service;
+        const std::size_t bytes = sizeof(EntryNode) - sizeof(MDNSService) + getServiceBytes(entry.service) +
+            getHeapBytes(it->first) + CONTAINER_OVERHEAD;
+        bytes_ = bytes_ - entry.bytes + bytes;
+        if (globalBudget_)
+        {
+            globalBudget_->remove(entry.bytes);
+            globalBudget_->add(bytes);
+        }
+        entry.bytes = bytes;
+
+        forgetEvicted(key);
+
+        evictOverLimit();
+    }
+    if (globalBudget_)
+        globalBudget_->enforce();
+    if (downstream_)
+        downstream_->onNewService(service);
+}
+
+void MDNSCachingBrowser::onRemovedService(const std::string &name, const std::string &type, const std::string &domain, MDNSInterfaceIndex interfaceIndex)
+{
+    const std::string key = makeKey(name, type, domain, interfaceIndex);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        if (it != entries_.end())
+        {
+            erase(it);
+            ++stats_.removals;
+        }
+        else
+        {
+            forgetEvicted(key);
+        }
+    }
+    if (downstream_)
+        downstream_->onRemovedService(name, type, domain, interfaceIndex);
+}
+
+void MDNSCachingBrowser::touch(Entry &entry)
+{
+    lru_.splice(lru_.begin(), lru_, entry.lruPos);
+}
+
+void MDNSCachingBrowser::erase(EntryMap::iterator it)
+{
+    Entry &entry = it->second;
+    bytes_ -= entry.bytes;
+    if (globalBudget_)
+        globalBudget_->remove(entry.bytes);
+    lru_.erase(entry.lruPos);
+    entries_.erase(it);
+}
+
+void MDNSCachingBrowser::evictLeastRecentlyUsed()
+{
+    // The key is remembered before its node is erased
+    rememberEvicted(lru_.back()->first);
+    erase(entries_.find(lru_.back()->first));
+    ++stats_.evictions;
+}
+
+void MDNSCachingBrowser::rememberEvicted(const std::string &key)
+{
+    if (evictedHistorySize_ == 0 || evicted_.count(key))
+        return;
+    if (evictedOrder_.size() >= evictedHistorySize_)
+        forgetEvicted(*evictedOrder_.front());
+    auto it = evicted_.insert(std::make_pair(key, EvictedList::iterator())).first;
+    evictedOrder_.push_back(&it->first);
+    it->second = --evictedOrder_.end();
+}
+
+bool MDNSCachingBrowser::forgetEvicted(const std::string &key)
+{
+    auto it = evicted_.find(key);
+    if (it == evicted_.end())
+        return false;
+    // key may refer to the node that is erased
+    evictedOrder_.erase(it->second);
+    evicted_.erase(it);
+    return true;
+}
+
+void MDNSCachingBrowser::evictOverLimit()
+{
+    while (limit_ != 0 && bytes_ > limit_ && !lru_.empty())
+        evictLeastRecentlyUsed();
+}
+
+bool MDNSCachingBrowser::evictOne()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (lru_.empty())
+        return false;
+    evictLeastRecentlyUsed();
+    return true;
+}
+
+std::size_t MDNSCachingBrowser::getUsedBytes() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bytes_;
+}
+
+} // namespace MDNS
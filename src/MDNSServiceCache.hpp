@@ -0,0 +1,207 @@
+/*
+ * MDNSServiceCache.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef MDNSSERVICECACHE_HPP_INCLUDED
+#define MDNSSERVICECACHE_HPP_INCLUDED
+
+#include "MDNSManager.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace MDNS
+{
+
+class MDNSCachingBrowser;
+
+/**
+ * Memory budget shared by several caching browsers. When the sum of all
+ * caches exceeds the limit, entries are evicted from the largest cache first.
+ */
+class MDNSCacheBudget
+{
+public:
+
+    typedef std::shared_ptr<MDNSCacheBudget> Ptr;
+
+    explicit MDNSCacheBudget(std::size_t limitBytes)
+        : limit_(limitBytes), used_(0), evictions_(0)
+    { }
+
+    std::size_t getLimit() const { return limit_.load(); }
+    void setLimit(std::size_t limitBytes);
+
+    std::size_t getUsedBytes() const { return used_.load(); }
+
+    /** Number of entries evicted because of this budget */
+    std::uint64_t getEvictions() const { return evictions_.load(); }
+
+private:
+
+    void attach(const std::shared_ptr<MDNSCachingBrowser> &cache);
+    void add(std::size_t bytes) { used_ += bytes; }
+    void remove(std::size_t bytes) { used_ -= bytes; }
+    void enforce();
+
+    std::atomic<std::size_t> limit_;
+    std::atomic<std::size_t> used_;
+    std::atomic<std::uint64_t> evictions_;
+
+    std::mutex mutex_;
+    std::vector<std::weak_ptr<MDNSCachingBrowser> > caches_;
+
+    friend class MDNSCachingBrowser;
+};
+
+enum MDNSEvictionPolicy
+{
+    /** Evict entry that was least recently updated or looked up */
+    MDNS_EVICT_LRU,
+    /** Evict entry that was least recently looked up, updates do not count */
+    MDNS_EVICT_LEAST_RECENTLY_QUERIED
+};
+
+/**
+ * Service browser that keeps discovered services in a memory bounded cache
+ * and forwards all events to an optional downstream browser.
+ *
+ * Memory is accounted per entry as the size of the cached MDNSService, all
+ * heap allocated strings (including every TXT record) and the container nodes.
+ * Allocator bookkeeping is not included.
+ */
+class MDNSCachingBrowser: public MDNSServiceBrowser,
+                          public std::enable_shared_from_this<MDNSCachingBrowser>
+{
+public:
+
+    typedef std::shared_ptr<MDNSCachingBrowser> Ptr;
+
+    /**
+     * Called when an evicted service is looked up, so that it can be
+     * resolved again.
+     */
+    typedef std::function<void (const std::string &name, const std::string &type,
+                                const std::string &domain, MDNSInterfaceIndex interfaceIndex)> ResolveHandler;
+
+    struct Stats
+    {
+        std::size_t entries;
+        std::size_t bytes;
+        std::size_t limit;
+        std::uint64_t inserts;
+        std::uint64_t updates;
+        std::uint64_t removals;
+        std::uint64_t evictions;
+        std::uint64_t hits;
+        std::uint64_t misses;
+        std::uint64_t reresolves;
+
+        Stats()
+            : entries(0), bytes(0), limit(0), inserts(0), updates(0), removals(0),
+              evictions(0), hits(0), misses(0), reresolves(0)
+        { }
+    };
+
+    /**
+     * Create cache with a per browser limit of limitBytes (0 means unlimited),
+     * optionally accounted also against the global budget.
+     */
+    static Ptr create(std::size_t limitBytes,
+                      const MDNSCacheBudget::Ptr &globalBudget = MDNSCacheBudget::Ptr(),
+                      const MDNSServiceBrowser::Ptr &downstream = MDNSServiceBrowser::Ptr(),
+                      MDNSEvictionPolicy policy = MDNS_EVICT_LRU);
+
+    ~MDNSCachingBrowser() override;
+
+    void setResolveHandler(const ResolveHandler &handler);
+
+    void setLimit(std::size_t limitBytes);
+
+    /**
+     * Number of evicted keys that are remembered to detect lookups of evicted
+     * services, default is 1024.
+     */
+    void setEvictedHistorySize(std::size_t size);
+
+    bool lookup(const std::string &name, const std::string &type, const std::string &domain,
+                MDNSInterfaceIndex interfaceIndex, MDNSService &service);
+
+    std::vector<MDNSService> getServices() const;
+
+    Stats getStats() const;
+
+    void onNewService(const MDNSService &service) override;
+
+    void onRemovedService(const std::string &name, const std::string &type, const std::string &domain, MDNSInterfaceIndex interfaceIndex) override;
+
+    /** Approximate heap and container footprint of a cached service in bytes */
+    static std::size_t getServiceBytes(const MDNSService &service);
+
+private:
+
+    struct Entry;
+    /** Map nodes are stable, the lists point to them instead of copying the keys */
+    typedef std::pair<const std::string, Entry> EntryNode;
+    typedef std::list<EntryNode *> LruList;
+    typedef std::list<const std::string *> EvictedList;
+
+    struct Entry
+    {
+        MDNSService service;
+        std::size_t bytes;
+        LruList::iterator lruPos;
+    };
+
+    typedef std::unordered_map<std::string, Entry> EntryMap;
+    typedef std::unordered_map<std::string, EvictedList::iterator> EvictedMap;
+
+    MDNSCachingBrowser(std::size_t limitBytes, const MDNSCacheBudget::Ptr &globalBudget,
+                       const MDNSServiceBrowser::Ptr &downstream, MDNSEvictionPolicy policy);
+
+    static std::string makeKey(const std::string &name, const std::string &type,
+                               const std::string &domain, MDNSInterfaceIndex interfaceIndex);
+
+    void touch(Entry &entry);
+    void erase(EntryMap::iterator it);
+    void evictLeastRecentlyUsed();
+    void rememberEvicted(const std::string &key);
+    bool forgetEvicted(const std::string &key);
+    void evictOverLimit();
+
+    /** Evict least recently used entry, used by the global budget */
+    bool evictOne();
+    std::size_t getUsedBytes() const;
+
+    const MDNSCacheBudget::Ptr globalBudget_;
+    const MDNSServiceBrowser::Ptr downstream_;
+    const MDNSEvictionPolicy policy_;
+
+    mutable std::mutex mutex_;
+    std::size_t limit_;
+    std::size_t bytes_;
+    EntryMap entries_;
+    /** Most recently used entries first */
+    LruList lru_;
+    EvictedMap evicted_;
+    /** Oldest evicted key first */
+    EvictedList evictedOrder_;
+    std::size_t evictedHistorySize_;
+    ResolveHandler resolveHandler_;
+    Stats stats_;
+
+    friend class MDNSCacheBudget;
+};
+
+} // namespace MDNS
+
+#endif /* MDNSSERVICECACHE_HPP_INCLUDED */
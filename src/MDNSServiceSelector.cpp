@@ -0,0 +1,301 @@
+/*
+ * MDNSServiceSelector.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include "MDNSServiceSelector.hpp"
+#include "MDNSStringRef.hpp"
+#include "MDNSTypedService.hpp"
+#include <limits>
+#include <random>
+
+namespace MDNS
+{
+
+// MDNSAliasTable
+
+MDNSAliasTable::MDNSAliasTable(const std::vector<ServicePtr> &services, const std::vector<std::uint32_t> &weights)
+    : services_(services)
+    , threshold_(services.size(), std::uint64_t(1) << 32)
+    , alias_(services.size(), 0)
+    , totalWeight_(0)
+{
+    const std::size_t n = services_.size();
+    for (std::size_t i = 0; i < n; ++i)
+        totalWeight_ += weights[i];
+    if (n == 0 || totalWeight_ == 0)
+        return;
+
+    // Vose's alias method on integer weights scaled by n, the average column
+    // has exactly totalWeight_
+    std::vector<std::uint64_t> scaled(n);
+    std::vector<std::uint32_t> small, large;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        scaled[i] = static_cast<std::uint64_t>(weights[i]) * n;
+        if (scaled[i] < totalWeight_)
+            small.push_back(static_cast<std::uint32_t>(i));
+        else
+            large.push_back(static_cast<std::uint32_t>(i));
+    }
+
+    while (!small.empty() && !large.empty())
+    {
+        const std::uint32_t s = small.back();
+        small.pop_back();
+        const std::uint32_t l = large.back();
+
+        threshold_[s] = static_cast<std::uint64_t>(
+            static_cast<long double>(scaled[s]) / totalWeight_ * 4294967296.0L);
+        alias_[s] = l;
+
+        scaled[l] = scaled[l] + scaled[s] - totalWeight_;
+        if (scaled[l] < totalWeight_)
+        {
+            large.pop_back();
+            small.push_back(l);
+        }
+    }
+    // Columns left over due to rounding keep their own service
+}
+
+// MDNSServiceSelector
+
+MDNSServiceSelector::MDNSServiceSelector(const Options &options, const MDNSServiceBrowser::Ptr &downstream)
+    : options_(options)
+    , downstream_(downstream)
+    , current_(domain_, new State())
+    , pendingChanges_(0)
+    , timer_([this]() { onDeadline(); })
+{
+}
+
+MDNSServiceSelector::~MDNSServiceSelector()
+{
+}
+
+std::uint64_t MDNSServiceSelector::nextRandom()
+{
+    // xorshift64*, seeded once per thread
+    static thread_local std::uint64_t state = 0;
+    if (state == 0)
+    {
+        std::random_device device;
+        state = (static_cast<std::uint64_t>(device()) << 32) | device() | 1;
+    }
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 2685821657736338717ull;
+}
+
+const MDNSService * MDNSServiceSelector::pick(const MDNSEpochDomain::ReadGuard &guard, const std::string &type,
+                                              const std::string &subtype) const
+{
+    const State *state = current_.load(guard);
+    auto it = state->tables.find(TableKey(type, subtype));
+    if (it == state->tables.end())
+        return 0;
+    return it->second->pick(nextRandom());
+}
+
+bool MDNSServiceSelector::pick(const std::string &type, MDNSService &service)
+{
+    return pick(type, std::string(), service);
+}
+
+bool MDNSServiceSelector::pick(const std::string &type, const std::string &subtype, MDNSService &service)
+{
+    MDNSEpochDomain::ReadGuard guard(domain_);
+    const MDNSService *picked = pick(guard, type, subtype);
+    if (!picked)
+        return false;
+    service = *picked;
+    return true;
+}
+
+std::size_t MDNSServiceSelector::getInstanceCount(const std::string &type, const std::string &subtype)
+{
+    MDNSEpochDomain::ReadGuard guard(domain_);
+    const State *state = current_.load(guard);
+    auto it = state->tables.find(TableKey(type, subtype));
+    return it == state->tables.end() ? 0 : it->second->size();
+}
+
+void MDNSServiceSelector::flush()
+{
+    std::lock_guard<std::mutex> lock(writerMutex_);
+    publish();
+}
+
+void MDNSServiceSelector::onNewService(const MDNSService &service)
+{
+    {
+        std::lock_guard<std::mutex> lock(writerMutex_);
+
+        Instance instance;
+        instance.service = std::make_shared<const MDNSService>(service);
+        instance.weight = options_.defaultWeight;
+        instance.priority = 0;
+
+        const std::vector<std::string> &txtRecords = service.getTxtRecords();
+        const MDNSStringRef weightKey(options_.weightKey);
+        const MDNSStringRef priorityKey(options_.priorityKey);
+        bool hasWeight = false, hasPriority = priorityKey.empty();
+        for (auto it = txtRecords.begin(), iend = txtRecords.end(); it != iend && !(hasWeight && hasPriority); ++it)
+        {
+            const MDNSStringRef record(*it);
+            const std::size_t eq = record.find('=');
+            if (eq == std::string::npos)
+                continue;
+            const MDNSStringRef key = record.substr(0, eq);
+            // RFC 6763 section 6.4: only the first occurrence of a key counts
+            if (!hasWeight && key.equalsIgnoreCase(weightKey))
+            {
+                hasWeight = true;
+                MDNSTxtValueTraits<std::uint32_t>::parse(record.substr(eq + 1), instance.weight);
+            }
+            else if (!hasPriority && key.equalsIgnoreCase(priorityKey))
+            {
+                hasPriority = true;
+                MDNSTxtValueTraits<std::uint32_t>::parse(record.substr(eq + 1), instance.priority);
+            }
+        }
+
+        InstanceMap &instances = instances_[service.getType()];
+        Instance &stored = instances[InstanceKey(service.getName(), service.getDomain(), service.getInterfaceIndex())];
+        // Subtypes of the previous announcement may have changed
+        if (stored.service)
+            markDirty(service.getType(), *stored.service);
+        stored = instance;
+        markDirty(service.getType(), service);
+        changed();
+    }
+    if (downstream_)
+        downstream_->onNewService(service);
+}
+
+void MDNSServiceSelector::onRemovedService(const std::string &name, const std::string &type, const std::string &domain, MDNSInterfaceIndex interfaceIndex)
+{
+    {
+        std::lock_guard<std::mutex> lock(writerMutex_);
+        auto it = instances_.find(type);
+        if (it != instances_.end())
+        {
+            auto instance = it->second.find(InstanceKey(name, domain, interfaceIndex));
+            if (instance != it->second.end())
+            {
+                markDirty(type, *instance->second.service);
+                it->second.erase(instance);
+                changed();
+            }
+        }
+    }
+    if (downstream_)
+        downstream_->onRemovedService(name, type, domain, interfaceIndex);
+}
+
+void MDNSServiceSelector::markDirty(const std::string &type, const MDNSService &service)
+{
+    dirty_.insert(TableKey(type, std::string()));
+    const std::vector<std::string> &subtypes = service.getSubtypes();
+    for (auto it = subtypes.begin(), iend = subtypes.end(); it != iend; ++it)
+        dirty_.insert(TableKey(type, *it));
+}
+
+void MDNSServiceSelector::changed()
+{
+    if (pendingChanges_++ == 0)
+        firstPending_ = Clock::now();
+    if (pendingChanges_ >= options_.maxPendingChanges || Clock::now() - firstPending_ >= options_.maxDelay)
+        publish();
+    else if (options_.maxDelay != Clock::duration::max())
+        timer_.arm(firstPending_ + options_.maxDelay);
+}
+
+void MDNSServiceSelector::onDeadline()
+{
+    std::lock_guard<std::mutex> lock(writerMutex_);
+    if (pendingChanges_ != 0)
+        publish();
+}
+
+static bool hasSubtype(const MDNSService &service, const std::string &subtype)
+{
+    if (subtype.empty())
+        return true;
+    const std::vector<std::string> &subtypes = service.getSubtypes();
+    for (auto it = subtypes.begin(), iend = subtypes.end(); it != iend; ++it)
+    {
+        if (*it == subtype)
+            return true;
+    }
+    return false;
+}
+
+std::shared_ptr<const MDNSAliasTable> MDNSServiceSelector::buildTable(const InstanceMap &instances, const std::string &subtype) const
+{
+    std::uint32_t minPriority = std::numeric_limits<std::uint32_t>::max();
+    for (auto it = instances.begin(), iend = instances.end(); it != iend; ++it)
+    {
+        if (it->second.priority < minPriority && hasSubtype(*it->second.service, subtype))
+            minPriority = it->second.priority;
+    }
+
+    bool allZero = true;
+    for (auto it = instances.begin(), iend = instances.end(); it != iend && allZero; ++it)
+    {
+        if (it->second.priority == minPriority && it->second.weight != 0 && hasSubtype(*it->second.service, subtype))
+            allZero = false;
+    }
+
+    // Weight 0 instances are never picked next to others, they are left out
+    std::vector<MDNSAliasTable::ServicePtr> services;
+    std::vector<std::uint32_t> weights;
+    for (auto it = instances.begin(), iend = instances.end(); it != iend; ++it)
+    {
+        if (it->second.priority != minPriority || !hasSubtype(*it->second.service, subtype) ||
+            (it->second.weight == 0 && !allZero))
+            continue;
+        services.push_back(it->second.service);
+        weights.push_back(allZero ? 1 : it->second.weight);
+    }
+    if (services.empty())
+        return std::shared_ptr<const MDNSAliasTable>();
+
+    return std::make_shared<const MDNSAliasTable>(services, weights);
+}
+
+void MDNSServiceSelector::publish()
+{
+    if (dirty_.empty())
+    {
+        domain_.reclaim();
+        return;
+    }
+
+    // Unchanged tables are shared with the previous state
+    State *state = new State(*current_.get());
+    for (auto it = dirty_.begin(), iend = dirty_.end(); it != iend; ++it)
+    {
+        auto instances = instances_.find(it->first);
+        std::shared_ptr<const MDNSAliasTable> table;
+        if (instances != instances_.end())
+            table = buildTable(instances->second, it->second);
+        if (table)
+            state->tables[*it] = table;
+        else
+            state->tables.erase(*it);
+
+        // Dirty keys are sorted, the remaining subtype tables of the type find no instances
+        if (instances != instances_.end() && instances->second.empty())
+            instances_.erase(instances);
+    }
+    dirty_.clear();
+    pendingChanges_ = 0;
+    timer_.disarm();
+    current_.publish(state);
+}
+
+} // namespace MDNS
@@ -0,0 +1,189 @@
+/*
+ * MDNSServiceSelector.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef MDNSSERVICESELECTOR_HPP_INCLUDED
+#define MDNSSERVICESELECTOR_HPP_INCLUDED
+
+#include "MDNSManager.hpp"
+#include "MDNSEpoch.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace MDNS
+{
+
+/**
+ * Alias method table (Vose) for O(1) weighted sampling of services.
+ */
+class MDNSAliasTable
+{
+public:
+
+    typedef std::shared_ptr<const MDNSService> ServicePtr;
+
+    MDNSAliasTable()
+        : totalWeight_(0)
+    { }
+
+    MDNSAliasTable(const std::vector<ServicePtr> &services, const std::vector<std::uint32_t> &weights);
+
+    std::size_t size() const { return services_.size(); }
+    bool empty() const { return services_.empty(); }
+    std::uint64_t getTotalWeight() const { return totalWeight_; }
+
+    /**
+     * Select service using 64 uniformly distributed random bits, returns null
+     * pointer when the table is empty.
+     */
+    const MDNSService * pick(std::uint64_t random) const
+    {
+        if (services_.empty())
+            return 0;
+        const std::uint32_t hi = static_cast<std::uint32_t>(random >> 32);
+        const std::uint32_t lo = static_cast<std::uint32_t>(random);
+        const std::size_t column = static_cast<std::size_t>((static_cast<std::uint64_t>(hi) * services_.size()) >> 32);
+        return services_[lo < threshold_[column] ? column : alias_[column]].get();
+    }
+
+private:
+    std::vector<ServicePtr> services_;
+    /** Probability to keep the column scaled to 2^32, alias is taken otherwise */
+    std::vector<std::uint64_t> threshold_;
+    std::vector<std::uint32_t> alias_;
+    std::uint64_t totalWeight_;
+};
+
+/**
+ * Client side load balancing: keeps an alias table per service type of all
+ * discovered instances, and per subtype of the instances announcing it, and
+ * picks instances in O(1) proportional to their weight.
+ *
+ * SRV priority and weight are not available through MDNSService, so weight
+ * and priority are read from TXT records. As with SRV records, only
+ * instances with the lowest priority value are selected; weight 0 instances
+ * are only selected when all instances of that priority have weight 0.
+ * TXT keys are compared case-insensitively (RFC 6763 section 6.4).
+ *
+ * Tables are immutable and published like in MDNSSnapshotBrowser: pick()
+ * is wait-free on any thread, the loop thread rebuilds the changed tables
+ * in batches: the table of the type and those of the subtypes the added or
+ * removed instance announces. Batches are published after maxDelay at the
+ * latest, also when no further change arrives.
+ */
+class MDNSServiceSelector: public MDNSServiceBrowser
+{
+public:
+
+    typedef std::shared_ptr<MDNSServiceSelector> Ptr;
+    typedef std::chrono::steady_clock Clock;
+
+    struct Options
+    {
+        /** TXT key with the weight of the instance */
+        std::string weightKey;
+        /** TXT key with the priority of the instance, empty to ignore priorities */
+        std::string priorityKey;
+        /** Weight of instances without valid weight */
+        std::uint32_t defaultWeight;
+        std::size_t maxPendingChanges;
+        Clock::duration maxDelay;
+
+        Options()
+            : weightKey("weight"), defaultWeight(1),
+              maxPendingChanges(64), maxDelay(std::chrono::milliseconds(20))
+        { }
+    };
+
+    explicit MDNSServiceSelector(const Options &options = Options(),
+                                 const MDNSServiceBrowser::Ptr &downstream = MDNSServiceBrowser::Ptr());
+
+    ~MDNSServiceSelector() override;
+
+    MDNSEpochDomain & getDomain() { return domain_; }
+
+    /**
+     * Pick weighted instance of the type, restricted to instances with the
+     * subtype unless it is empty. Returns null pointer if there is no
+     * instance. The service is valid as long as the guard exists.
+     */
+    const MDNSService * pick(const MDNSEpochDomain::ReadGuard &guard, const std::string &type,
+                             const std::string &subtype = std::string()) const;
+
+    /** Pick weighted instance and copy it */
+    bool pick(const std::string &type, MDNSService &service);
+
+    /** Pick weighted instance with the subtype and copy it */
+    bool pick(const std::string &type, const std::string &subtype, MDNSService &service);
+
+    /**
+     * Number of instances pick() may return for the type (and subtype) in
+     * the current tables: those with the lowest priority and a weight other
+     * than 0, or all of them when all have weight 0.
+     */
+    std::size_t getInstanceCount(const std::string &type, const std::string &subtype = std::string());
+
+    void flush();
+
+    void onNewService(const MDNSService &service) override;
+
+    void onRemovedService(const std::string &name, const std::string &type, const std::string &domain, MDNSInterfaceIndex interfaceIndex) override;
+
+private:
+
+    /** Type and subtype, the subtype is empty for the table of all instances */
+    typedef std::pair<std::string, std::string> TableKey;
+
+    struct State
+    {
+        std::map<TableKey, std::shared_ptr<const MDNSAliasTable> > tables;
+    };
+
+    struct Instance
+    {
+        MDNSAliasTable::ServicePtr service;
+        std::uint32_t weight;
+        std::uint32_t priority;
+    };
+
+    typedef std::tuple<std::string, std::string, MDNSInterfaceIndex> InstanceKey;
+    typedef std::map<InstanceKey, Instance> InstanceMap;
+
+    static std::uint64_t nextRandom();
+
+    void markDirty(const std::string &type, const MDNSService &service);
+    void changed();
+    void onDeadline();
+    void publish();
+    std::shared_ptr<const MDNSAliasTable> buildTable(const InstanceMap &instances, const std::string &subtype) const;
+
+    const Options options_;
+    const MDNSServiceBrowser::Ptr downstream_;
+
+    MDNSEpochDomain domain_;
+    MDNSPublished<State> current_;
+
+    /** Writer side state */
+    std::mutex writerMutex_;
+    std::map<std::string, InstanceMap> instances_;
+    std::set<TableKey> dirty_;
+    std::size_t pendingChanges_;
+    Clock::time_point firstPending_;
+
+    /** Last member, its thread is joined before the state above is destroyed */
+    MDNSDeadlineTimer timer_;
+};
+
+} // namespace MDNS
+
+#endif /* MDNSSERVICESELECTOR_HPP_INCLUDED */
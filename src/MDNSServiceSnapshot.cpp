@@ -0,0 +1,186 @@
+/*
+ * MDNSServiceSnapshot.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include "MDNSServiceSnapshot.hpp"
+#include <algorithm>
+
+namespace MDNS
+{
+
+// MDNSServiceSet
+
+int MDNSServiceSet::compare(const MDNSService &service, const std::string &name, const std::string &type,
+                            const std::string &domain, MDNSInterfaceIndex interfaceIndex)
+{
+    int r = service.getType().compare(type);
+    if (r != 0)
+        return r;
+    r = service.getName().compare(name);
+    if (r != 0)
+        return r;
+    r = service.getDomain().compare(domain);
+    if (r != 0)
+        return r;
+    if (service.getInterfaceIndex() != interfaceIndex)
+        return service.getInterfaceIndex() < interfaceIndex ? -1 : 1;
+    return 0;
+}
+
+const MDNSService * MDNSServiceSet::find(const std::string &name, const std::string &type,
+                                         const std::string &domain, MDNSInterfaceIndex interfaceIndex) const
+{
+    const_iterator it = std::lower_bound(services_.begin(), services_.end(), 0,
+        [&](const ServicePtr &service, int)
+        {
+            return compare(*service, name, type, domain, interfaceIndex) < 0;
+        });
+    if (it != services_.end() && compare(**it, name, type, domain, interfaceIndex) == 0)
+        return it->get();
+    return 0;
+}
+
+std::pair<MDNSServiceSet::const_iterator, MDNSServiceSet::const_iterator>
+MDNSServiceSet::findByType(const std::string &type) const
+{
+    const_iterator first = std::lower_bound(services_.begin(), services_.end(), 0,
+        [&](const ServicePtr &service, int) { return service->getType() < type; });
+    const_iterator last = std::upper_bound(first, services_.end(), 0,
+        [&](int, const ServicePtr &service) { return type < service->getType(); });
+    return std::make_pair(first, last);
+}
+
+// MDNSSnapshotBrowser
+
+MDNSSnapshotBrowser::MDNSSnapshotBrowser(std::size_t maxPendingChanges,
+                                         Clock::duration maxDelay,
+                                         const MDNSServiceBrowser::Ptr &downstream)
+    : current_(domain_, new MDNSServiceSet())
+    , maxPendingChanges_(maxPendingChanges)
+    , maxDelay_(maxDelay)
+    , downstream_(downstream)
+    , timer_([this]() { onDeadline(); })
+{
+}
+
+MDNSSnapshotBrowser::~MDNSSnapshotBrowser()
+{
+}
+
+bool MDNSSnapshotBrowser::lookup(const std::string &name, const std::string &type, const std::string &domain,
+                                 MDNSInterfaceIndex interfaceIndex, MDNSService &service)
+{
+    MDNSEpochDomain::ReadGuard guard(domain_);
+    const MDNSService *found = getSnapshot(guard)->find(name, type, domain, interfaceIndex);
+    if (!found)
+        return false;
+    service = *found;
+    return true;
+}
+
+void MDNSSnapshotBrowser::flush()
+{
+    std::lock_guard<std::mutex> lock(writerMutex_);
+    publish();
+}
+
+MDNSSnapshotBrowser::Stats MDNSSnapshotBrowser::getStats() const
+{
+    std::lock_guard<std::mutex> lock(writerMutex_);
+    Stats stats = stats_;
+    stats.pendingReclaims = domain_.getPendingCount();
+    return stats;
+}
+
+void MDNSSnapshotBrowser::onNewService(const MDNSService &service)
+{
+    {
+        std::lock_guard<std::mutex> lock(writerMutex_);
+        if (pending_.empty())
+            firstPending_ = Clock::now();
+        pending_[Key(service.getType(), service.getName(), service.getDomain(), service.getInterfaceIndex())] =
+            std::make_shared<const MDNSService>(service);
+        changed();
+    }
+    if (downstream_)
+        downstream_->onNewService(service);
+}
+
+void MDNSSnapshotBrowser::onRemovedService(const std::string &name, const std::string &type, const std::string &domain, MDNSInterfaceIndex interfaceIndex)
+{
+    {
+        std::lock_guard<std::mutex> lock(writerMutex_);
+        if (pending_.empty())
+            firstPending_ = Clock::now();
+        pending_[Key(type, name, domain, interfaceIndex)] = MDNSServiceSet::ServicePtr();
+        changed();
+    }
+    if (downstream_)
+        downstream_->onRemovedService(name, type, domain, interfaceIndex);
+}
+
+void MDNSSnapshotBrowser::changed()
+{
+    ++stats_.changes;
+    if (pending_.size() >= maxPendingChanges_ || Clock::now() - firstPending_ >= maxDelay_)
+        publish();
+    else if (maxDelay_ != Clock::duration::max())
+        timer_.arm(firstPending_ + maxDelay_);
+}
+
+void MDNSSnapshotBrowser::onDeadline()
+{
+    std::lock_guard<std::mutex> lock(writerMutex_);
+    if (!pending_.empty())
+        publish();
+}
+
+void MDNSSnapshotBrowser::publish()
+{
+    if (pending_.empty())
+    {
+        domain_.reclaim();
+        return;
+    }
+
+    const MDNSServiceSet *old = current_.get();
+    MDNSServiceSet *version = new MDNSServiceSet();
+    version->generation_ = old->generation_ + 1;
+    version->services_.reserve(old->services_.size() + pending_.size());
+
+    // Both sequences are sorted by (type, name, domain, interface index)
+    auto it = old->services_.begin(), iend = old->services_.end();
+    auto change = pending_.begin(), changeEnd = pending_.end();
+    while (it != iend || change != changeEnd)
+    {
+        int r;
+        if (it == iend)
+            r = 1;
+        else if (change == changeEnd)
+            r = -1;
+        else
+            r = MDNSServiceSet::compare(**it, std::get<1>(change->first), std::get<0>(change->first),
+                                        std::get<2>(change->first), std::get<3>(change->first));
+        if (r < 0)
+        {
+            version->services_.push_back(*it++);
+        }
+        else
+        {
+            if (change->second)
+                version->services_.push_back(change->second);
+            if (r == 0)
+                ++it;
+            ++change;
+        }
+    }
+
+    pending_.clear();
+    timer_.disarm();
+    current_.publish(version);
+    ++stats_.publishes;
+}
+
+} // namespace MDNS
@@ -0,0 +1,152 @@
+/*
+ * MDNSServiceSnapshot.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef MDNSSERVICESNAPSHOT_HPP_INCLUDED
+#define MDNSSERVICESNAPSHOT_HPP_INCLUDED
+
+#include "MDNSManager.hpp"
+#include "MDNSEpoch.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace MDNS
+{
+
+/**
+ * Immutable version of the set of discovered services, sorted by type, name,
+ * domain and interface index.
+ */
+class MDNSServiceSet
+{
+public:
+
+    typedef std::shared_ptr<const MDNSService> ServicePtr;
+    typedef std::vector<ServicePtr>::const_iterator const_iterator;
+
+    MDNSServiceSet()
+        : generation_(0)
+    { }
+
+    std::uint64_t getGeneration() const { return generation_; }
+    std::size_t size() const { return services_.size(); }
+    bool empty() const { return services_.empty(); }
+
+    const_iterator begin() const { return services_.begin(); }
+    const_iterator end() const { return services_.end(); }
+
+    const MDNSService * find(const std::string &name, const std::string &type,
+                             const std::string &domain, MDNSInterfaceIndex interfaceIndex) const;
+
+    /** All services of the given type */
+    std::pair<const_iterator, const_iterator> findByType(const std::string &type) const;
+
+    static int compare(const MDNSService &service, const std::string &name, const std::string &type,
+                       const std::string &domain, MDNSInterfaceIndex interfaceIndex);
+
+private:
+    std::uint64_t generation_;
+    std::vector<ServicePtr> services_;
+
+    friend class MDNSSnapshotBrowser;
+};
+
+/**
+ * Service browser that publishes the discovered services as immutable
+ * MDNSServiceSet versions.
+ *
+ * Readers on any thread access a consistent version wait-free, except for the
+ * first guard of a thread, which acquires a reader slot under a mutex:
+ *
+ *   MDNSEpochDomain::ReadGuard guard(browser->getDomain());
+ *   const MDNSServiceSet *services = browser->getSnapshot(guard);
+ *
+ * The callbacks, which run on the loop thread of the manager, collect changes
+ * and publish a new version when maxPendingChanges changes are pending or
+ * the oldest pending change is older than maxDelay, checked by a deadline
+ * timer when no further change arrives. flush() publishes pending changes
+ * immediately.
+ */
+class MDNSSnapshotBrowser: public MDNSServiceBrowser
+{
+public:
+
+    typedef std::shared_ptr<MDNSSnapshotBrowser> Ptr;
+    typedef std::chrono::steady_clock Clock;
+
+    struct Stats
+    {
+        std::uint64_t publishes;
+        std::uint64_t changes;
+        std::size_t pendingReclaims;
+
+        Stats() : publishes(0), changes(0), pendingReclaims(0) { }
+    };
+
+    explicit MDNSSnapshotBrowser(std::size_t maxPendingChanges = 64,
+                                 Clock::duration maxDelay = std::chrono::milliseconds(20),
+                                 const MDNSServiceBrowser::Ptr &downstream = MDNSServiceBrowser::Ptr());
+
+    ~MDNSSnapshotBrowser() override;
+
+    MDNSEpochDomain & getDomain() { return domain_; }
+
+    const MDNSServiceSet * getSnapshot(const MDNSEpochDomain::ReadGuard &guard) const
+    {
+        return current_.load(guard);
+    }
+
+    /**
+     * Copy service from the current version, returns false if not found.
+     */
+    bool lookup(const std::string &name, const std::string &type, const std::string &domain,
+                MDNSInterfaceIndex interfaceIndex, MDNSService &service);
+
+    void flush();
+
+    Stats getStats() const;
+
+    void onNewService(const MDNSService &service) override;
+
+    void onRemovedService(const std::string &name, const std::string &type, const std::string &domain, MDNSInterfaceIndex interfaceIndex) override;
+
+private:
+
+    typedef std::tuple<std::string, std::string, std::string, MDNSInterfaceIndex> Key;
+
+    /** Called with writerMutex_ held after a change was added */
+    void changed();
+    void onDeadline();
+    void publish();
+
+    MDNSEpochDomain domain_;
+    MDNSPublished<MDNSServiceSet> current_;
+
+    const std::size_t maxPendingChanges_;
+    const Clock::duration maxDelay_;
+    const MDNSServiceBrowser::Ptr downstream_;
+
+    /** Writer side state, never touched by readers */
+    mutable std::mutex writerMutex_;
+    /** Pending changes, null pointer means removal */
+    std::map<Key, MDNSServiceSet::ServicePtr> pending_;
+    Clock::time_point firstPending_;
+    Stats stats_;
+
+    /** Last member, its thread is joined before the state above is destroyed */
+    MDNSDeadlineTimer timer_;
+};
+
+} // namespace MDNS
+
+#endif /* MDNSSERVICESNAPSHOT_HPP_INCLUDED */
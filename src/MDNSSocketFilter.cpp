@@ -0,0 +1,504 @@
+/*
+ * MDNSSocketFilter.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include "MDNSSocketFilter.hpp"
+#include "MDNSPacket.hpp"
+#include <cstring>
+
+#ifdef __linux__
+#include <cerrno>
+#include <linux/filter.h>
+#include <sys/socket.h>
+#endif
+
+namespace MDNS
+{
+
+namespace
+{
+
+// Classic BPF opcodes, see linux/filter.h and bpf(4)
+enum
+{
+    BPF_LD_ = 0x00, BPF_LDX_ = 0x01, BPF_ST_ = 0x02, BPF_STX_ = 0x03,
+    BPF_ALU_ = 0x04, BPF_JMP_ = 0x05, BPF_RET_ = 0x06, BPF_MISC_ = 0x07,
+
+    BPF_W_ = 0x00, BPF_H_ = 0x08, BPF_B_ = 0x10,
+
+    BPF_IMM_ = 0x00, BPF_ABS_ = 0x20, BPF_IND_ = 0x40, BPF_MEM_ = 0x60, BPF_LEN_ = 0x80, BPF_MSH_ = 0xa0,
+
+    BPF_ADD_ = 0x00, BPF_SUB_ = 0x10, BPF_MUL_ = 0x20, BPF_DIV_ = 0x30, BPF_OR_ = 0x40,
+    BPF_AND_ = 0x50, BPF_LSH_ = 0x60, BPF_RSH_ = 0x70, BPF_NEG_ = 0x80,
+
+    BPF_JA_ = 0x00, BPF_JEQ_ = 0x10, BPF_JGT_ = 0x20, BPF_JGE_ = 0x30, BPF_JSET_ = 0x40,
+
+    BPF_K_ = 0x00, BPF_X_ = 0x08, BPF_A_ = 0x10,
+
+    BPF_TAX_ = 0x00, BPF_TXA_ = 0x80
+};
+
+const std::size_t MAX_INSTRUCTIONS = 4096;
+const std::uint32_t ACCEPT_ALL = 0xFFFFFFFFu;
+
+/**
+ * Emits instructions with symbolic jump targets. Conditional jumps may only
+ * reach 255 instructions, far targets are reached through "ja".
+ */
+class ProgramBuilder
+{
+public:
+
+    enum { NEXT = -1 };
+
+    int newLabel()
+    {
+        labels_.push_back(-1);
+        return static_cast<int>(labels_.size() - 1);
+    }
+
+    void bind(int label)
+    {
+        labels_[label] = static_cast<int>(code_.size());
+    }
+
+    void emit(std::uint16_t code, std::uint32_t k)
+    {
+        Pending p = { { code, 0, 0, k }, NEXT, NEXT };
+        code_.push_back(p);
+    }
+
+    void jump(std::uint16_t code, std::uint32_t k, int trueLabel, int falseLabel)
+    {
+        Pending p = { { static_cast<std::uint16_t>(BPF_JMP_ | code), 0, 0, k }, trueLabel, falseLabel };
+        code_.push_back(p);
+    }
+
+    void jumpAlways(int label)
+    {
+        Pending p = { { BPF_JMP_ | BPF_JA_, 0, 0, 0 }, label, NEXT };
+        code_.push_back(p);
+    }
+
+    /** Jump far to label if condition is true */
+    void jumpFarIf(std::uint16_t code, std::uint32_t k, int label)
+    {
+        const int skip = newLabel();
+        jump(code, k, NEXT, skip);
+        jumpAlways(label);
+        bind(skip);
+    }
+
+    /** Jump far to label if condition is false */
+    void jumpFarUnless(std::uint16_t code, std::uint32_t k, int label)
+    {
+        const int skip = newLabel();
+        jump(code, k, skip, NEXT);
+        jumpAlways(label);
+        bind(skip);
+    }
+
+    bool build(std::vector<MDNSBpfInstruction> &program)
+    {
+        program.clear();
+        if (code_.size() > MAX_INSTRUCTIONS)
+            return false;
+        for (std::size_t i = 0; i < code_.size(); ++i)
+        {
+            MDNSBpfInstruction insn = code_[i].insn;
+            if ((insn.code & 0x07) == BPF_JMP_)
+            {
+                if ((insn.code & 0xf0) == BPF_JA_)
+                {
+                    insn.k = static_cast<std::uint32_t>(target(code_[i].jt, i));
+                }
+                else
+                {
+                    const int jt = target(code_[i].jt, i);
+                    const int jf = target(code_[i].jf, i);
+                    if (jt > 255 || jf > 255)
+                        return false;
+                    insn.jt = static_cast<std::uint8_t>(jt);
+                    insn.jf = static_cast<std::uint8_t>(jf);
+                }
+            }
+            program.push_back(insn);
+        }
+        return true;
+    }
+
+private:
+
+    struct Pending
+    {
+        MDNSBpfInstruction insn;
+        int jt;
+        int jf;
+    };
+
+    int target(int label, std::size_t pos) const
+    {
+        return label == NEXT ? 0 : labels_[label] - static_cast<int>(pos) - 1;
+    }
+
+    std::vector<Pending> code_;
+    std::vector<int> labels_;
+};
+
+/**
+ * Compare wire name at offset (absolute or relative to X) case-insensitively,
+ * jump to fail if it doesn't match, fall through otherwise.
+ */
+void emitNameCompare(ProgramBuilder &b, const std::string &wire, std::uint32_t offset, bool indirect, int fail)
+{
+    // Case bit mask for letters, label length bytes are compared exactly
+    std::vector<std::uint8_t> mask(wire.size(), 0);
+    for (std::size_t pos = 0; pos < wire.size() && wire[pos] != '\0'; )
+    {
+        const std::size_t len = static_cast<std::uint8_t>(wire[pos]);
+        for (std::size_t i = pos + 1; i <= pos + len && i < wire.size(); ++i)
+        {
+            const char c = wire[i];
+            if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'))
+                mask[i] = 0x20;
+        }
+        pos += len + 1;
+    }
+
+    const std::uint16_t mode = indirect ? BPF_IND_ : BPF_ABS_;
+    for (std::size_t i = 0; i < wire.size(); )
+    {
+        const std::size_t remaining = wire.size() - i;
+        const std::size_t width = remaining >= 4 ? 4 : (remaining >= 2 ? 2 : 1);
+        const std::uint16_t size = width == 4 ? BPF_W_ : (width == 2 ? BPF_H_ : BPF_B_);
+        std::uint32_t value = 0, m = 0;
+        for (std::size_t j = 0; j < width; ++j)
+        {
+            value = (value << 8) | static_cast<std::uint8_t>(wire[i + j]);
+            m = (m << 8) | mask[i + j];
+        }
+        b.emit(BPF_LD_ | size | mode, offset + static_cast<std::uint32_t>(i));
+        if (m)
+            b.emit(BPF_ALU_ | BPF_OR_ | BPF_K_, m);
+        b.jump(BPF_JEQ_ | BPF_K_, value | m, ProgramBuilder::NEXT, fail);
+        i += width;
+    }
+}
+
+/** Accept if the name at offset equals one of the wire names */
+void emitExactMatches(ProgramBuilder &b, const std::vector<std::string> &names, std::uint32_t offset, int accept)
+{
+    for (auto it = names.begin(), iend = names.end(); it != iend; ++it)
+    {
+        const int fail = b.newLabel();
+        b.emit(BPF_LD_ | BPF_W_ | BPF_LEN_, 0);
+        b.jump(BPF_JGE_ | BPF_K_, offset + static_cast<std::uint32_t>(it->size()), ProgramBuilder::NEXT, fail);
+        emitNameCompare(b, *it, offset, false, fail);
+        b.jumpAlways(accept);
+        b.bind(fail);
+    }
+}
+
+std::string defaultDomain(const std::string &domain)
+{
+    return domain.empty() ? std::string("local") : domain;
+}
+
+void addUnique(std::vector<std::string> &names, const std::string &name)
+{
+    for (auto it = names.begin(), iend = names.end(); it != iend; ++it)
+    {
+        if (equalNames(*it, name))
+            return;
+    }
+    names.push_back(name);
+}
+
+} // namespace
+
+MDNSSocketFilter::MDNSSocketFilter()
+{
+}
+
+MDNSSocketFilter & MDNSSocketFilter::addBrowseType(const std::string &type, const std::string &domain)
+{
+    const std::string wire = toWireName(type + "." + defaultDomain(domain));
+    addUnique(responseExact_, wire);
+    addUnique(responseInstanceOf_, wire);
+    return *this;
+}
+
+MDNSSocketFilter & MDNSSocketFilter::addBrowseSubtype(const std::string &subtype, const std::string &type, const std::string &domain)
+{
+    addUnique(responseExact_, toWireName(subtype + "._sub." + type + "." + defaultDomain(domain)));
+    // SRV and TXT records of subtype instances are named after the base type
+    addUnique(responseInstanceOf_, toWireName(type + "." + defaultDomain(domain)));
+    return *this;
+}
+
+MDNSSocketFilter & MDNSSocketFilter::addPublishedType(const std::string &type, const std::string &domain)
+{
+    const std::string wire = toWireName(type + "." + defaultDomain(domain));
+    addUnique(queryExact_, wire);
+    // Responses of other instances of the type reveal name conflicts
+    addUnique(responseInstanceOf_, wire);
+    return *this;
+}
+
+MDNSSocketFilter & MDNSSocketFilter::addPublishedSubtype(const std::string &subtype, const std::string &type, const std::string &domain)
+{
+    addUnique(queryExact_, toWireName(subtype + "._sub." + type + "." + defaultDomain(domain)));
+    return *this;
+}
+
+MDNSSocketFilter & MDNSSocketFilter::addOwnedInstance(const std::string &instance, const std::string &type, const std::string &domain)
+{
+    const std::string wire = toWireName(makeInstanceName(instance, type, defaultDomain(domain)));
+    addUnique(queryExact_, wire);
+    addUnique(responseExact_, wire);
+    return *this;
+}
+
+MDNSSocketFilter & MDNSSocketFilter::addOwnedHost(const std::string &host)
+{
+    const std::string wire = toWireName(host);
+    addUnique(queryExact_, wire);
+    addUnique(responseExact_, wire);
+    return *this;
+}
+
+MDNSSocketFilter & MDNSSocketFilter::addBrowsedHost(const std::string &host)
+{
+    addUnique(responseExact_, toWireName(host));
+    return *this;
+}
+
+bool MDNSSocketFilter::isEmpty() const
+{
+    return queryExact_.empty() && responseExact_.empty() && responseInstanceOf_.empty();
+}
+
+std::vector<MDNSBpfInstruction> MDNSSocketFilter::compile(std::uint32_t payloadOffset) const
+{
+    const MDNSBpfInstruction acceptAll = { BPF_RET_ | BPF_K_, 0, 0, ACCEPT_ALL };
+    std::vector<MDNSBpfInstruction> program;
+    if (isEmpty())
+        return std::vector<MDNSBpfInstruction>(1, acceptAll);
+
+    const std::uint32_t P = payloadOffset;
+    const std::uint32_t nameOffset = P + 12;
+
+    ProgramBuilder b;
+    const int accept = b.newLabel();
+    const int drop = b.newLabel();
+    const int response = b.newLabel();
+
+    // DNS header and at least the first length byte
+    b.emit(BPF_LD_ | BPF_W_ | BPF_LEN_, 0);
+    b.jumpFarUnless(BPF_JGE_ | BPF_K_, nameOffset + 1, drop);
+
+    b.emit(BPF_LD_ | BPF_H_ | BPF_ABS_, P + 2);
+    b.jumpFarIf(BPF_JSET_ | BPF_K_, MDNS_FLAG_TRUNCATED, accept);
+    b.jumpFarIf(BPF_JSET_ | BPF_K_, MDNS_FLAG_RESPONSE, response);
+
+    // Query: only a single question can be examined
+    b.emit(BPF_LD_ | BPF_H_ | BPF_ABS_, P + 4);
+    b.jumpFarIf(BPF_JEQ_ | BPF_K_, 0, drop);
+    b.jumpFarIf(BPF_JGT_ | BPF_K_, 1, accept);
+    emitExactMatches(b, queryExact_, nameOffset, accept);
+    b.jumpAlways(drop);
+
+    // Response: first record, questions and further answers can't be
+    // examined without loops
+    b.bind(response);
+    b.emit(BPF_LD_ | BPF_H_ | BPF_ABS_, P + 4);
+    b.jumpFarIf(BPF_JGT_ | BPF_K_, 0, accept);
+    b.emit(BPF_LD_ | BPF_H_ | BPF_ABS_, P + 6);
+    b.jumpFarIf(BPF_JGT_ | BPF_K_, 1, accept);
+    emitExactMatches(b, responseExact_, nameOffset, accept);
+
+    if (!responseInstanceOf_.empty())
+    {
+        // M[0] = length of the first label, instance label is 1..63 bytes
+        b.emit(BPF_LD_ | BPF_B_ | BPF_ABS_, nameOffset);
+        b.jumpFarIf(BPF_JEQ_ | BPF_K_, 0, drop);
+        b.jumpFarIf(BPF_JGT_ | BPF_K_, 63, drop);
+        b.emit(BPF_ST_, 0);
+
+        for (auto it = responseInstanceOf_.begin(), iend = responseInstanceOf_.end(); it != iend; ++it)
+        {
+            const int fail = b.newLabel();
+            const std::uint32_t typeOffset = nameOffset + 1;
+            // Require M[0] + typeOffset + size <= packet length
+            b.emit(BPF_LD_ | BPF_W_ | BPF_LEN_, 0);
+            b.emit(BPF_MISC_ | BPF_TAX_, 0);
+            b.emit(BPF_LD_ | BPF_MEM_, 0);
+            b.emit(BPF_ALU_ | BPF_ADD_ | BPF_K_, typeOffset + static_cast<std::uint32_t>(it->size()));
+            b.jump(BPF_JGT_ | BPF_X_, 0, fail, ProgramBuilder::NEXT);
+            b.emit(BPF_LDX_ | BPF_W_ | BPF_MEM_, 0);
+            emitNameCompare(b, *it, typeOffset, true, fail);
+            b.jumpAlways(accept);
+            b.bind(fail);
+        }
+    }
+    b.jumpAlways(drop);
+
+    b.bind(accept);
+    b.emit(BPF_RET_ | BPF_K_, ACCEPT_ALL);
+    b.bind(drop);
+    b.emit(BPF_RET_ | BPF_K_, 0);
+
+    // Too many names for one program, don't filter at all
+    if (!b.build(program))
+        return std::vector<MDNSBpfInstruction>(1, acceptAll);
+    return program;
+}
+
+std::uint32_t MDNSSocketFilter::run(const std::vector<MDNSBpfInstruction> &program, const void *data, std::size_t size)
+{
+    const std::uint8_t *packet = static_cast<const std::uint8_t *>(data);
+    std::uint32_t A = 0, X = 0;
+    std::uint32_t M[16] = { 0 };
+
+    for (std::size_t pc = 0; pc < program.size(); ++pc)
+    {
+        const MDNSBpfInstruction &insn = program[pc];
+        const std::uint32_t k = insn.k;
+        switch (insn.code & 0x07)
+        {
+            case BPF_LD_:
+            case BPF_LDX_:
+            {
+                std::uint32_t value;
+                const std::uint16_t mode = insn.code & 0xe0;
+                const std::uint16_t width = insn.code & 0x18;
+                if (mode == BPF_ABS_ || mode == BPF_IND_ || mode == BPF_MSH_)
+                {
+                    const std::uint64_t offset = (mode == BPF_IND_ ? static_cast<std::uint64_t>(X) : 0) + k;
+                    const std::size_t bytes = width == BPF_W_ ? 4 : (width == BPF_H_ ? 2 : 1);
+                    // Out of bounds loads abort the program like in the kernel
+                    if (offset + bytes > size)
+                        return 0;
+                    value = 0;
+                    for (std::size_t i = 0; i < bytes; ++i)
+                        value = (value << 8) | packet[offset + i];
+                    if (mode == BPF_MSH_)
+                        value = 4 * (value & 0xf);
+                }
+                else if (mode == BPF_LEN_)
+                    value = static_cast<std::uint32_t>(size);
+                else if (mode == BPF_MEM_)
+                    value = M[k & 0xf];
+                else
+                    value = k;
+                if ((insn.code & 0x07) == BPF_LD_)
+                    A = value;
+                else
+                    X = value;
+                break;
+            }
+            case BPF_ST_:
+                M[k & 0xf] = A;
+                break;
+            case BPF_STX_:
+                M[k & 0xf] = X;
+                break;
+            case BPF_ALU_:
+            {
+                const std::uint32_t operand = (insn.code & BPF_X_) ? X : k;
+                switch (insn.code & 0xf0)
+                {
+                    case BPF_ADD_: A += operand; break;
+                    case BPF_SUB_: A -= operand; break;
+                    case BPF_MUL_: A *= operand; break;
+                    case BPF_DIV_: if (operand == 0) return 0; A /= operand; break;
+                    case BPF_OR_: A |= operand; break;
+                    case BPF_AND_: A &= operand; break;
+                    case BPF_LSH_: A <<= operand; break;
+                    case BPF_RSH_: A >>= operand; break;
+                    case BPF_NEG_: A = 0u - A; break;
+                    default: return 0;
+                }
+                break;
+            }
+            case BPF_JMP_:
+            {
+                const std::uint32_t operand = (insn.code & BPF_X_) ? X : k;
+                bool condition;
+                switch (insn.code & 0xf0)
+                {
+                    case BPF_JA_: pc += k; continue;
+                    case BPF_JEQ_: condition = A == operand; break;
+                    case BPF_JGT_: condition = A > operand; break;
+                    case BPF_JGE_: condition = A >= operand; break;
+                    case BPF_JSET_: condition = (A & operand) != 0; break;
+                    default: return 0;
+                }
+                pc += condition ? insn.jt : insn.jf;
+                break;
+            }
+            case BPF_RET_:
+                return (insn.code & 0x18) == BPF_A_ ? A : k;
+            case BPF_MISC_:
+                if ((insn.code & 0xf8) == BPF_TXA_)
+                    A = X;
+                else
+                    X = A;
+                break;
+        }
+    }
+    return 0;
+}
+
+bool MDNSSocketFilter::attach(int fd, const std::vector<MDNSBpfInstruction> &program, std::string *error)
+{
+#ifdef __linux__
+    std::vector<sock_filter> filter(program.size());
+    for (std::size_t i = 0; i < program.size(); ++i)
+    {
+        filter[i].code = program[i].code;
+        filter[i].jt = program[i].jt;
+        filter[i].jf = program[i].jf;
+        filter[i].k = program[i].k;
+    }
+    sock_fprog fprog;
+    fprog.len = static_cast<unsigned short>(filter.size());
+    fprog.filter = filter.data();
+    if (setsockopt(fd, SOL_SOCKET, SO_ATTACH_FILTER, &fprog, sizeof(fprog)) < 0)
+    {
+        if (error)
+            *error = std::string("SO_ATTACH_FILTER failed: ") + std::strerror(errno);
+        return false;
+    }
+    return true;
+#else
+    (void)fd;
+    (void)program;
+    if (error)
+        *error = "Socket filters are only supported on Linux";
+    return false;
+#endif
+}
+
+bool MDNSSocketFilter::detach(int fd, std::string *error)
+{
+#ifdef __linux__
+    int dummy = 0;
+    if (setsockopt(fd, SOL_SOCKET, SO_DETACH_FILTER, &dummy, sizeof(dummy)) < 0)
+    {
+        if (error)
+            *error = std::string("SO_DETACH_FILTER failed: ") + std::strerror(errno);
+        return false;
+    }
+    return true;
+#else
+    (void)fd;
+    if (error)
+        *error = "Socket filters are only supported on Linux";
+    return false;
+#endif
+}
+
+} // namespace MDNS
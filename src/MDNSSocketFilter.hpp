@@ -0,0 +1,106 @@
+/*
+ * MDNSSocketFilter.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef MDNSSOCKETFILTER_HPP_INCLUDED
+#define MDNSSOCKETFILTER_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace MDNS
+{
+
+/**
+ * Classic BPF instruction, same layout as struct sock_filter of Linux.
+ */
+struct MDNSBpfInstruction
+{
+    std::uint16_t code;
+    std::uint8_t jt;
+    std::uint8_t jf;
+    std::uint32_t k;
+};
+
+/**
+ * Compiles the names a daemon-free responder/browser is interested in into
+ * a classic BPF socket filter, so that irrelevant mDNS packets are dropped
+ * in the kernel without waking up the process.
+ *
+ * The filter looks at the first name of a message, which is always
+ * uncompressed. Classic BPF can't loop over the following, possibly
+ * compressed names, so messages with more than one question or answer are
+ * accepted without looking at them:
+ *
+ * - queries with a single question are accepted when it asks for a
+ *   published service type or subtype, an owned instance or an owned host
+ *   name;
+ * - responses with at most one answer are accepted when the first record is
+ *   a browsed type or subtype, an instance of a browsed or published type, a
+ *   browsed host (SRV target) or an owned name (conflict);
+ * - queries with several questions (e.g. probes of multiple records),
+ *   responses with several answers or carrying questions, truncated
+ *   messages and all names that are too long to be compared are accepted.
+ *
+ * Name comparison is ASCII case-insensitive.
+ */
+class MDNSSocketFilter
+{
+public:
+
+    /** Offset of the DNS message in the packet seen by the filter of a UDP socket */
+    static const std::uint32_t UDP_PAYLOAD_OFFSET = 8;
+
+    MDNSSocketFilter();
+
+    /** Type like "_http._tcp", domain defaults to "local" */
+    MDNSSocketFilter & addBrowseType(const std::string &type, const std::string &domain = std::string());
+    MDNSSocketFilter & addBrowseSubtype(const std::string &subtype, const std::string &type, const std::string &domain = std::string());
+    MDNSSocketFilter & addPublishedType(const std::string &type, const std::string &domain = std::string());
+    MDNSSocketFilter & addPublishedSubtype(const std::string &subtype, const std::string &type, const std::string &domain = std::string());
+    MDNSSocketFilter & addOwnedInstance(const std::string &instance, const std::string &type, const std::string &domain = std::string());
+    /** Host name like "myhost.local" */
+    MDNSSocketFilter & addOwnedHost(const std::string &host);
+    /** Target host of a browsed instance, whose address records are needed to resolve it */
+    MDNSSocketFilter & addBrowsedHost(const std::string &host);
+
+    /** Accept everything when nothing was added, e.g. while no browser is active */
+    bool isEmpty() const;
+
+    /**
+     * Compile the filter. payloadOffset is the offset of the DNS message in the
+     * data the filter sees, UDP_PAYLOAD_OFFSET for UDP sockets and 0 to run the
+     * program on bare DNS messages.
+     */
+    std::vector<MDNSBpfInstruction> compile(std::uint32_t payloadOffset = UDP_PAYLOAD_OFFSET) const;
+
+    /**
+     * Execute program in user space, returns the number of bytes to accept,
+     * 0 means drop. Used for testing and on platforms without socket filters.
+     */
+    static std::uint32_t run(const std::vector<MDNSBpfInstruction> &program, const void *data, std::size_t size);
+
+    /**
+     * Attach program to the socket (Linux only), replacing a previous filter.
+     * Returns false and sets error on failure.
+     */
+    static bool attach(int fd, const std::vector<MDNSBpfInstruction> &program, std::string *error = 0);
+
+    static bool detach(int fd, std::string *error = 0);
+
+private:
+
+    /** Names compared as a whole, in wire format */
+    std::vector<std::string> queryExact_;
+    std::vector<std::string> responseExact_;
+    /** Types whose instances ("<label>.<type>") are accepted in responses */
+    std::vector<std::string> responseInstanceOf_;
+};
+
+} // namespace MDNS
+
+#endif /* MDNSSOCKETFILTER_HPP_INCLUDED */
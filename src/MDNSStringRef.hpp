@@ -0,0 +1,151 @@
+/*
+ * MDNSStringRef.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef MDNSSTRINGREF_HPP_INCLUDED
+#define MDNSSTRINGREF_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+
+namespace MDNS
+{
+
+/**
+ * Non-owning reference to a character sequence, used by accessors that must
+ * not allocate.
+ */
+class MDNSStringRef
+{
+public:
+
+    MDNSStringRef()
+        : data_(""), size_(0)
+    { }
+
+    MDNSStringRef(const char *str)
+        : data_(str), size_(std::strlen(str))
+    { }
+
+    MDNSStringRef(const char *data, std::size_t size)
+        : data_(data), size_(size)
+    { }
+
+    MDNSStringRef(const std::string &str)
+        : data_(str.data()), size_(str.size())
+    { }
+
+    const char * data() const { return data_; }
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    const char * begin() const { return data_; }
+    const char * end() const { return data_ + size_; }
+
+    char operator[](std::size_t i) const { return data_[i]; }
+
+    MDNSStringRef substr(std::size_t pos, std::size_t count = std::string::npos) const
+    {
+        if (pos > size_)
+            pos = size_;
+        if (count > size_ - pos)
+            count = size_ - pos;
+        return MDNSStringRef(data_ + pos, count);
+    }
+
+    std::size_t find(char c, std::size_t pos = 0) const
+    {
+        for (std::size_t i = pos; i < size_; ++i)
+        {
+            if (data_[i] == c)
+                return i;
+        }
+        return std::string::npos;
+    }
+
+    std::string str() const { return std::string(data_, size_); }
+
+    bool operator==(const MDNSStringRef &other) const
+    {
+        return size_ == other.size_ && std::memcmp(data_, other.data_, size_) == 0;
+    }
+
+    bool operator!=(const MDNSStringRef &other) const
+    {
+        return !(*this == other);
+    }
+
+    /** ASCII case-insensitive comparison, e.g. for TXT keys (RFC 6763 section 6.4) */
+    bool equalsIgnoreCase(const MDNSStringRef &other) const
+    {
+        if (size_ != other.size_)
+            return false;
+        for (std::size_t i = 0; i < size_; ++i)
+        {
+            if (toLowerAscii(data_[i]) != toLowerAscii(other.data_[i]))
+                return false;
+        }
+        return true;
+    }
+
+    static constexpr char toLowerAscii(char c)
+    {
+        return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    bool operator<(const MDNSStringRef &other) const
+    {
+        const int r = std::memcmp(data_, other.data_, size_ < other.size_ ? size_ : other.size_);
+        return r < 0 || (r == 0 && size_ < other.size_);
+    }
+
+private:
+    const char *data_;
+    std::size_t size_;
+};
+
+inline std::ostream & operator<<(std::ostream &out, const MDNSStringRef &ref)
+{
+    return out.write(ref.data(), static_cast<std::streamsize>(ref.size()));
+}
+
+/**
+ * 32-bit FNV-1a hash, usable in constant expressions.
+ */
+constexpr std::uint32_t fnv1a(const char *str, std::uint32_t hash = 2166136261u)
+{
+    return *str ? fnv1a(str + 1, (hash ^ static_cast<unsigned char>(*str)) * 16777619u) : hash;
+}
+
+inline std::uint32_t fnv1a(const MDNSStringRef &str)
+{
+    std::uint32_t hash = 2166136261u;
+    for (const char *c = str.begin(), *cend = str.end(); c != cend; ++c)
+        hash = (hash ^ static_cast<unsigned char>(*c)) * 16777619u;
+    return hash;
+}
+
+/**
+ * FNV-1a hash of the ASCII lower case form, consistent with equalsIgnoreCase().
+ */
+constexpr std::uint32_t fnv1aIgnoreCase(const char *str, std::uint32_t hash = 2166136261u)
+{
+    return *str ? fnv1aIgnoreCase(str + 1, (hash ^ static_cast<unsigned char>(MDNSStringRef::toLowerAscii(*str))) * 16777619u) : hash;
+}
+
+inline std::uint32_t fnv1aIgnoreCase(const MDNSStringRef &str)
+{
+    std::uint32_t hash = 2166136261u;
+    for (const char *c = str.begin(), *cend = str.end(); c != cend; ++c)
+        hash = (hash ^ static_cast<unsigned char>(MDNSStringRef::toLowerAscii(*c))) * 16777619u;
+    return hash;
+}
+
+} // namespace MDNS
+
+#endif /* MDNSSTRINGREF_HPP_INCLUDED */
@@ -0,0 +1,556 @@
+/*
+ * MDNSTypedService.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef MDNSTYPEDSERVICE_HPP_INCLUDED
+#define MDNSTYPEDSERVICE_HPP_INCLUDED
+
+#include "MDNSManager.hpp"
+#include "MDNSStringRef.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Compile-time declarations of service types, subtypes and TXT schemas.
+ *
+ * Usage:
+ *
+ *   MDNS_TXT_KEY(PathKey, "path", MDNSStringRef, "/");
+ *   MDNS_TXT_KEY(WeightKey, "weight", unsigned int, 1);
+ *   MDNS_SERVICE_TYPE(HttpService, "_http._tcp", MDNSTxtSchema<PathKey, WeightKey>);
+ *   MDNS_SERVICE_SUBTYPE(ArvidaSubtype, HttpService, "_arvida");
+ *
+ *   MDNSTxtView<HttpService::TxtSchema> txt(service);
+ *   MDNSStringRef path = txt.get<PathKey>();
+ *
+ *   constexpr auto wire = ArvidaSubtype::wireName();  // "\x07_arvida\x04_sub\x05_http..."
+ *
+ * Misspelled keys or types are unknown identifiers and do not compile, keys
+ * that are not part of a schema are rejected by static_assert.
+ */
+
+namespace MDNS
+{
+
+namespace Detail
+{
+
+constexpr bool isValidTxtKeyChars(const char *key)
+{
+    return *key == '\0' ||
+        (*key >= 0x20 && *key <= 0x7E && *key != '=' && isValidTxtKeyChars(key + 1));
+}
+
+constexpr std::size_t constStrLen(const char *str)
+{
+    return *str ? 1 + constStrLen(str + 1) : 0;
+}
+
+constexpr bool constStrEndsWith(const char *str, std::size_t len, const char *suffix, std::size_t suffixLen)
+{
+    return len >= suffixLen &&
+        (suffixLen == 0 || (str[len - 1] == suffix[suffixLen - 1] &&
+                            constStrEndsWith(str, len - 1, suffix, suffixLen - 1)));
+}
+
+/** RFC 6763 section 6.4: keys are 1-9 (at most 255) printable characters except '=' */
+constexpr bool isValidTxtKey(const char *key)
+{
+    return constStrLen(key) > 0 && constStrLen(key) <= 255 && isValidTxtKeyChars(key);
+}
+
+/** RFC 6763 section 7: "_<name>._tcp" or "_<name>._udp", name up to 15 characters */
+constexpr bool isValidServiceType(const char *type)
+{
+    return type[0] == '_' && constStrLen(type) > 6 && constStrLen(type) <= 21 &&
+        (constStrEndsWith(type, constStrLen(type), "._tcp", 5) ||
+         constStrEndsWith(type, constStrLen(type), "._udp", 5));
+}
+
+constexpr bool isValidSubtype(const char *subtype)
+{
+    return subtype[0] == '_' && constStrLen(subtype) > 1 && constStrLen(subtype) <= 63;
+}
+
+// Perfect hash: smallest table size for which (hash % size) is distinct for all keys
+
+constexpr bool slotIsFree(std::uint32_t, std::uint32_t)
+{
+    return true;
+}
+
+template <class... Hashes>
+constexpr bool slotIsFree(std::uint32_t slot, std::uint32_t size, std::uint32_t hash, Hashes... rest)
+{
+    return hash % size != slot && slotIsFree(slot, size, rest...);
+}
+
+constexpr bool allSlotsDistinct(std::uint32_t)
+{
+    return true;
+}
+
+template <class... Hashes>
+constexpr bool allSlotsDistinct(std::uint32_t size, std::uint32_t hash, Hashes... rest)
+{
+    return slotIsFree(hash % size, size, rest...) && allSlotsDistinct(size, rest...);
+}
+
+template <class... Hashes>
+constexpr std::uint32_t perfectHashSize(std::uint32_t size, std::uint32_t limit, Hashes... hashes)
+{
+    return size > limit ? 0 :
+        (allSlotsDistinct(size, hashes...) ? size : perfectHashSize(size + 1, limit, hashes...));
+}
+
+// Names in the "local" domain concatenated from up to three parts, and their wire format
+
+constexpr char partsCharAt(const char *a, const char *b, const char *c, std::size_t i)
+{
+    return i < constStrLen(a) ? a[i] :
+        (*b || *c ? partsCharAt(b, c, "", i - constStrLen(a)) : '\0');
+}
+
+constexpr std::size_t partsLength(const char *a, const char *b, const char *c)
+{
+    return constStrLen(a) + constStrLen(b) + constStrLen(c);
+}
+
+constexpr std::size_t labelLength(const char *a, const char *b, const char *c, std::size_t i)
+{
+    return i >= partsLength(a, b, c) || partsCharAt(a, b, c, i) == '.' ? 0 : 1 + labelLength(a, b, c, i + 1);
+}
+
+/** Byte i of the wire format, label lengths replace the dots of the dotted name */
+constexpr char wireCharAt(const char *a, const char *b, const char *c, std::size_t i)
+{
+    return i == partsLength(a, b, c) + 1 ? '\0' :
+        (i == 0 || partsCharAt(a, b, c, i - 1) == '.') ?
+            static_cast<char>(labelLength(a, b, c, i)) : partsCharAt(a, b, c, i - 1);
+}
+
+template <std::size_t... I>
+struct IndexSequence { };
+
+template <std::size_t N, std::size_t... I>
+struct MakeIndexSequence : MakeIndexSequence<N - 1, N - 1, I...> { };
+
+template <std::size_t... I>
+struct MakeIndexSequence<0, I...>
+{
+    typedef IndexSequence<I...> Type;
+};
+
+template <class Key, class... Keys>
+struct IndexOf;
+
+template <class Key>
+struct IndexOf<Key>
+{
+    static constexpr int value = -1;
+};
+
+template <class Key, class... Rest>
+struct IndexOf<Key, Key, Rest...>
+{
+    static constexpr int value = 0;
+};
+
+template <class Key, class First, class... Rest>
+struct IndexOf<Key, First, Rest...>
+{
+    static constexpr int value = IndexOf<Key, Rest...>::value < 0 ? -1 : 1 + IndexOf<Key, Rest...>::value;
+};
+
+} // namespace Detail
+
+/**
+ * DNS wire format of a declared service type or subtype in the "local" domain,
+ * computed at compile time. Byte for byte equal to toWireName() from MDNSPacket,
+ * including the terminating root label.
+ */
+template <std::size_t N>
+struct MDNSWireName
+{
+    static constexpr std::size_t length = N;
+
+    char bytes[N];
+
+    constexpr std::size_t size() const { return N; }
+    constexpr const char * data() const { return bytes; }
+
+    MDNSStringRef ref() const { return MDNSStringRef(bytes, N); }
+    std::string str() const { return std::string(bytes, N); }
+};
+
+namespace Detail
+{
+
+template <std::size_t N, std::size_t... I>
+constexpr MDNSWireName<N> makeWireName(const char *a, const char *b, const char *c, IndexSequence<I...>)
+{
+    return MDNSWireName<N>{ { wireCharAt(a, b, c, I)... } };
+}
+
+/** Wire name of the dotted name a + b + c, N must be partsLength(a, b, c) + 2 */
+template <std::size_t N>
+constexpr MDNSWireName<N> makeWireName(const char *a, const char *b, const char *c)
+{
+    return makeWireName<N>(a, b, c, typename MakeIndexSequence<N>::Type());
+}
+
+} // namespace Detail
+
+/**
+ * Conversion between TXT values and typed values. parse() must not allocate
+ * for MDNSStringRef and arithmetic types.
+ */
+template <class T, class Enable = void>
+struct MDNSTxtValueTraits;
+
+template <>
+struct MDNSTxtValueTraits<MDNSStringRef>
+{
+    static bool parse(const MDNSStringRef &in, MDNSStringRef &out) { out = in; return true; }
+    static std::string format(const MDNSStringRef &value) { return value.str(); }
+};
+
+template <>
+struct MDNSTxtValueTraits<std::string>
+{
+    static bool parse(const MDNSStringRef &in, std::string &out) { out = in.str(); return true; }
+    static std::string format(const std::string &value) { return value; }
+};
+
+template <>
+struct MDNSTxtValueTraits<bool>
+{
+    /** RFC 6763 section 6.4: a key without value is a boolean attribute that is present */
+    static bool parse(const MDNSStringRef &in, bool &out)
+    {
+        if (in.empty() || in == "1" || in == "true" || in == "yes")
+            out = true;
+        else if (in == "0" || in == "false" || in == "no")
+            out = false;
+        else
+            return false;
+        return true;
+    }
+    static std::string format(bool value) { return value ? "1" : "0"; }
+};
+
+template <class T>
+struct MDNSTxtValueTraits<T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value>::type>
+{
+    /** Returns false for values out of the range of T */
+    static bool parse(const MDNSStringRef &in, T &out)
+    {
+        typedef typename std::make_unsigned<T>::type U;
+        const char *c = in.begin(), *cend = in.end();
+        bool negative = false;
+        if (c != cend && *c == '-' && std::is_signed<T>::value)
+        {
+            negative = true;
+            ++c;
+        }
+        if (c == cend)
+            return false;
+        // Magnitude of the smallest negative value is one more than the largest
+        const U limit = static_cast<U>(std::numeric_limits<T>::max()) + (negative ? 1 : 0);
+        U value = 0;
+        for (; c != cend; ++c)
+        {
+            if (*c < '0' || *c > '9')
+                return false;
+            const U digit = static_cast<U>(*c - '0');
+            if (value > (limit - digit) / 10)
+                return false;
+            value = static_cast<U>(value * 10 + digit);
+        }
+        if (!negative)
+            out = static_cast<T>(value);
+        else
+            out = value == 0 ? T(0) : static_cast<T>(-static_cast<T>(value - 1) - 1);
+        return true;
+    }
+    static std::string format(T value) { return std::to_string(value); }
+};
+
+/**
+ * Declares TXT key type Name with the given key string, value type and default value.
+ */
+#define MDNS_TXT_KEY(Name, keyString, ValueType, defaultValue_)                  \
+    struct Name                                                                   \
+    {                                                                             \
+        typedef ValueType ValueT;                                                 \
+        static_assert(::MDNS::Detail::isValidTxtKey(keyString),                   \
+                      "Invalid TXT key " keyString);                              \
+        static constexpr const char *key() { return keyString; }                  \
+        static constexpr std::size_t keyLength()                                  \
+        { return ::MDNS::Detail::constStrLen(keyString); }                        \
+        static constexpr std::uint32_t hash()                                     \
+        { return ::MDNS::fnv1aIgnoreCase(keyString); }                            \
+        static ValueT defaultValue() { return ValueT(defaultValue_); }            \
+    }
+
+/**
+ * Ordered set of TXT keys with a perfect hash for the lookup of received keys.
+ * Keys are case-insensitive (RFC 6763 section 6.4), keys differing in case
+ * only are duplicates.
+ */
+template <class... Keys>
+class MDNSTxtSchema
+{
+public:
+
+    static constexpr std::size_t size = sizeof...(Keys);
+
+    static constexpr std::uint32_t tableSize =
+        Detail::perfectHashSize(static_cast<std::uint32_t>(sizeof...(Keys) ? sizeof...(Keys) : 1),
+                                static_cast<std::uint32_t>(16 * sizeof...(Keys) + 16),
+                                Keys::hash()...);
+
+    static_assert(tableSize != 0, "TXT schema contains duplicate keys or no perfect hash could be found");
+
+    template <class Key>
+    static constexpr int indexOf()
+    {
+        return Detail::IndexOf<Key, Keys...>::value;
+    }
+
+    /**
+     * Returns index of the key in the schema or -1 when key is unknown.
+     */
+    static int lookup(const MDNSStringRef &key)
+    {
+        const Table &table = getTable();
+        const std::uint32_t slot = fnv1aIgnoreCase(key) % tableSize;
+        const int index = table.indices[slot];
+        if (index < 0 || !key.equalsIgnoreCase(table.keys[index]))
+            return -1;
+        return index;
+    }
+
+    static const char * keyAt(std::size_t index)
+    {
+        return getTable().keys[index].data();
+    }
+
+private:
+
+    struct Table
+    {
+        signed short indices[tableSize];
+        MDNSStringRef keys[sizeof...(Keys) ? sizeof...(Keys) : 1];
+
+        Table()
+        {
+            for (std::uint32_t i = 0; i < tableSize; ++i)
+                indices[i] = -1;
+            const char *keyStrings[] = { Keys::key()..., 0 };
+            const std::uint32_t hashes[] = { Keys::hash()..., 0 };
+            for (std::size_t i = 0; i < sizeof...(Keys); ++i)
+            {
+                indices[hashes[i] % tableSize] = static_cast<signed short>(i);
+                keys[i] = MDNSStringRef(keyStrings[i]);
+            }
+        }
+    };
+
+    static const Table & getTable()
+    {
+        static const Table table;
+        return table;
+    }
+};
+
+/**
+ * Typed, non-allocating view on the TXT records of a service.
+ * The view references the strings of the service and must not outlive it.
+ */
+template <class Schema>
+class MDNSTxtView
+{
+public:
+
+    MDNSTxtView()
+        : present_(0)
+    { }
+
+    explicit MDNSTxtView(const MDNSService &service)
+        : present_(0)
+    {
+        assign(service.getTxtRecords().begin(), service.getTxtRecords().end());
+    }
+
+    template <class Iterator>
+    MDNSTxtView(Iterator begin, Iterator end)
+        : present_(0)
+    {
+        assign(begin, end);
+    }
+
+    template <class Key>
+    bool has() const
+    {
+        return (present_ & (std::uint64_t(1) << checkedIndex<Key>())) != 0;
+    }
+
+    /**
+     * Returns value of the key, or default value of the key if it is missing
+     * or can't be parsed.
+     */
+    template <class Key>
+    typename Key::ValueT get() const
+    {
+        typename Key::ValueT value;
+        if (!get<Key>(value))
+            value = Key::defaultValue();
+        return value;
+    }
+
+    template <class Key>
+    bool get(typename Key::ValueT &value) const
+    {
+        if (!has<Key>())
+            return false;
+        return MDNSTxtValueTraits<typename Key::ValueT>::parse(values_[checkedIndex<Key>()], value);
+    }
+
+    template <class Key>
+    MDNSStringRef getRaw() const
+    {
+        return has<Key>() ? values_[checkedIndex<Key>()] : MDNSStringRef();
+    }
+
+private:
+
+    static_assert(Schema::size <= 64, "TXT schema is limited to 64 keys");
+
+    template <class Key>
+    static constexpr std::size_t checkedIndex()
+    {
+        static_assert(Schema::template indexOf<Key>() >= 0, "TXT key is not part of the schema");
+        return static_cast<std::size_t>(Schema::template indexOf<Key>());
+    }
+
+    template <class Iterator>
+    void assign(Iterator begin, Iterator end)
+    {
+        for (Iterator it = begin; it != end; ++it)
+        {
+            const MDNSStringRef record(*it);
+            const std::size_t eq = record.find('=');
+            const MDNSStringRef key = record.substr(0, eq);
+            const int index = Schema::lookup(key);
+            // RFC 6763 section 6.4: only the first occurrence of a key counts
+            if (index < 0 || (present_ & (std::uint64_t(1) << index)))
+                continue;
+            present_ |= std::uint64_t(1) << index;
+            values_[index] = eq == std::string::npos ? MDNSStringRef() : record.substr(eq + 1);
+        }
+    }
+
+    std::uint64_t present_;
+    MDNSStringRef values_[Schema::size ? Schema::size : 1];
+};
+
+/**
+ * Declares service type Name with its type string and TXT schema, the schema
+ * is passed last so that it may contain unparenthesized commas.
+ */
+#define MDNS_SERVICE_TYPE(Name, typeString, ...)                                  \
+    struct Name                                                                   \
+    {                                                                             \
+        typedef __VA_ARGS__ TxtSchema;                                            \
+        static_assert(::MDNS::Detail::isValidServiceType(typeString),             \
+                      "Invalid service type " typeString);                        \
+        static constexpr const char *type() { return typeString; }                \
+        typedef ::MDNS::MDNSWireName<                                             \
+            ::MDNS::Detail::constStrLen(typeString ".local") + 2> WireNameT;      \
+        /** e.g. "\x05_http\x04_tcp\x05local\x00" */                              \
+        static constexpr WireNameT wireName()                                     \
+        {                                                                         \
+            return ::MDNS::Detail::makeWireName<WireNameT::length>(               \
+                typeString ".local", "", "");                                     \
+        }                                                                         \
+    }
+
+/**
+ * Declares subtype Name of the service type ServiceType.
+ */
+#define MDNS_SERVICE_SUBTYPE(Name, ServiceType, subtypeString)                    \
+    struct Name                                                                   \
+    {                                                                             \
+        typedef ServiceType ServiceT;                                             \
+        typedef ServiceType::TxtSchema TxtSchema;                                 \
+        static_assert(::MDNS::Detail::isValidSubtype(subtypeString),              \
+                      "Invalid subtype " subtypeString);                          \
+        static constexpr const char *type() { return ServiceType::type(); }       \
+        static constexpr const char *subtype() { return subtypeString; }          \
+        typedef ::MDNS::MDNSWireName<                                             \
+            ::MDNS::Detail::partsLength(subtypeString "._sub.",                   \
+                                        ServiceType::type(), ".local") + 2>       \
+            WireNameT;                                                            \
+        /** e.g. "\x07_arvida\x04_sub\x05_http\x04_tcp\x05local\x00" */           \
+        static constexpr WireNameT wireName()                                     \
+        {                                                                         \
+            return ::MDNS::Detail::makeWireName<WireNameT::length>(               \
+                subtypeString "._sub.", ServiceType::type(), ".local");           \
+        }                                                                         \
+    }
+
+/** Service types are compared case-insensitively like all DNS names */
+template <class ServiceType>
+bool isServiceOfType(const MDNSService &service)
+{
+    return MDNSStringRef(service.getType()).equalsIgnoreCase(
+        MDNSStringRef(ServiceType::type(), Detail::constStrLen(ServiceType::type())));
+}
+
+template <class ServiceType>
+MDNSService & setServiceType(MDNSService &service)
+{
+    return service.setType(ServiceType::type());
+}
+
+template <class Subtype>
+MDNSService & addServiceSubtype(MDNSService &service)
+{
+    return service.addSubtype(Subtype::subtype());
+}
+
+template <class Key>
+MDNSService & addTxtValue(MDNSService &service, const typename Key::ValueT &value)
+{
+    return service.addTxtRecord(std::string(Key::key()) + "=" + MDNSTxtValueTraits<typename Key::ValueT>::format(value));
+}
+
+template <class ServiceType>
+void registerTypedServiceBrowser(MDNSManager &manager,
+                                 const MDNSServiceBrowser::Ptr & browser,
+                                 MDNSInterfaceIndex interfaceIndex,
+                                 const std::string &domain)
+{
+    manager.registerServiceBrowser(browser, interfaceIndex, ServiceType::type(), domain);
+}
+
+template <class Subtype>
+void registerTypedSubtypeBrowser(MDNSManager &manager,
+                                 const MDNSServiceBrowser::Ptr & browser,
+                                 MDNSInterfaceIndex interfaceIndex,
+                                 const std::string &domain)
+{
+    const std::vector<std::string> subtypes(1, Subtype::subtype());
+    manager.registerServiceBrowser(browser, interfaceIndex, Subtype::type(), subtypes, domain);
+}
+
+} // namespace MDNS
+
+#endif /* MDNSTYPEDSERVICE_HPP_INCLUDED */
@@ -0,0 +1,345 @@
+/*
+ * bench_collision_resolution.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+// Time until all of many identically named services are registered, with
+// renaming by the backend only (like client-publish-service.c) compared to
+// MDNSCollisionResolver picking names from the browse cache, also when the
+// backend's new name after a collision is known to be taken.
+//
+// Probing is simulated on a virtual clock following RFC 6762: every attempt
+// waits 0-250 ms and sends three probes 250 ms apart, a name that is already
+// owned collides, and a host with 15 conflicts within 10 s waits 5 s. A
+// registered name becomes visible in the browse cache of the other hosts after
+// 20-120 ms. Name selection runs the real MDNSNameRegistry code, renames after
+// a collision run MDNSNameRegistry::resolveCollision() like
+// MDNSCollisionResolver::onAlternativeServiceName. The resolver's manager calls
+// need a running backend and are simulated as a new probe.
+//
+// Usage: bench_collision_resolution [services]
+
+#include "MDNSCollisionResolver.hpp"
+#include "MDNSManager.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <queue>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace MDNS;
+
+namespace
+{
+
+const char * const SERVICE_NAME = "Printer";
+const char * const SERVICE_TYPE = "_ipp._tcp";
+
+enum Strategy
+{
+    BACKEND_ONLY,
+    RESOLVER_SEQUENTIAL,
+    RESOLVER_HOST_SUFFIX
+};
+
+const char * toString(Strategy strategy)
+{
+    switch (strategy)
+    {
+        case BACKEND_ONLY: return "backend rename";
+        case RESOLVER_SEQUENTIAL: return "resolver, sequential";
+        case RESOLVER_HOST_SUFFIX: return "resolver, host suffix";
+    }
+    return "?";
+}
+
+struct Scenario
+{
+    std::size_t hosts;
+    std::size_t servicesPerHost;
+    /** Hosts start evenly distributed over this time */
+    std::int64_t startSpreadMs;
+};
+
+struct Result
+{
+    std::int64_t timeToAllMs;
+    std::uint64_t collisions;
+    std::uint32_t maxCollisionsPerService;
+    double pickMicroseconds;
+};
+
+/** Rename like avahi_alternative_service_name: "Foo" -> "Foo #2" -> "Foo #3" */
+std::string backendAlternativeName(const std::string &name)
+{
+    const std::size_t hash = name.rfind(" #");
+    if (hash != std::string::npos && hash + 2 < name.size() &&
+        name.find_first_not_of("0123456789", hash + 2) == std::string::npos)
+    {
+        std::ostringstream s;
+        s << name.substr(0, hash) << " #" << std::strtoul(name.c_str() + hash + 2, 0, 10) + 1;
+        return s.str();
+    }
+    return name + " #2";
+}
+
+class Simulation
+{
+public:
+
+    Simulation(const Scenario &scenario, Strategy strategy)
+        : scenario_(scenario)
+        , strategy_(strategy)
+        , random_(12345)
+        , hosts_(scenario.hosts)
+        , services_(scenario.hosts * scenario.servicesPerHost)
+        , registered_(0)
+        , collisions_(0)
+        , pickTime_(0)
+        , picks_(0)
+    {
+        for (std::size_t h = 0; h < hosts_.size(); ++h)
+        {
+            std::ostringstream id;
+            id << "host-" << h;
+            hosts_[h].id = id.str();
+            hosts_[h].registry = std::make_shared<MDNSNameRegistry>();
+        }
+    }
+
+    Result run()
+    {
+        for (std::size_t i = 0; i < services_.size(); ++i)
+        {
+            const std::size_t h = i / scenario_.servicesPerHost;
+            services_[i].host = h;
+            services_[i].generation = 0;
+            services_[i].collisions = 0;
+            const std::int64_t start = scenario_.hosts > 1 ? scenario_.startSpreadMs * std::int64_t(h) / std::int64_t(scenario_.hosts - 1) : 0;
+            schedule(start, START, i, std::string());
+        }
+
+        std::int64_t now = 0;
+        while (!events_.empty() && registered_ < services_.size())
+        {
+            const Event event = events_.top();
+            events_.pop();
+            now = event.time;
+            switch (event.kind)
+            {
+                case START: start(event); break;
+                case PROBE: beginProbe(event.service, event.name, now); break;
+                case PROBE_DONE: probeDone(event); break;
+                case VISIBLE: visible(event); break;
+            }
+        }
+
+        Result result;
+        result.timeToAllMs = now;
+        result.collisions = collisions_;
+        result.maxCollisionsPerService = 0;
+        for (auto it = services_.begin(), iend = services_.end(); it != iend; ++it)
+        {
+            if (it->collisions > result.maxCollisionsPerService)
+                result.maxCollisionsPerService = it->collisions;
+        }
+        result.pickMicroseconds = picks_ ? pickTime_ / picks_ : 0.0;
+        return result;
+    }
+
+private:
+
+    enum EventKind { START, PROBE, PROBE_DONE, VISIBLE };
+
+    struct Event
+    {
+        std::int64_t time;
+        std::uint64_t sequence;
+        EventKind kind;
+        /** Service index, or host index for VISIBLE */
+        std::size_t service;
+        std::uint32_t generation;
+        std::string name;
+
+        bool operator<(const Event &other) const
+        {
+            // Earliest first in std::priority_queue
+            return time != other.time ? time > other.time : sequence > other.sequence;
+        }
+    };
+
+    struct Host
+    {
+        std::string id;
+        MDNSNameRegistry::Ptr registry;
+        /** Names probing or owned on this host, the backend rejects duplicates */
+        std::set<std::string> active;
+        std::deque<std::int64_t> conflicts;
+    };
+
+    struct Service
+    {
+        std::size_t host;
+        std::string name;
+        std::uint32_t generation;
+        std::uint32_t collisions;
+    };
+
+    std::uint32_t nextRandom()
+    {
+        random_ ^= random_ << 13;
+        random_ ^= random_ >> 17;
+        random_ ^= random_ << 5;
+        return random_;
+    }
+
+    MDNSRenameStrategy getRenameStrategy() const
+    {
+        return strategy_ == RESOLVER_HOST_SUFFIX ? MDNS_RENAME_HOST_SUFFIX : MDNS_RENAME_SEQUENTIAL;
+    }
+
+    void schedule(std::int64_t time, EventKind kind, std::size_t service, const std::string &name, std::uint32_t generation = 0)
+    {
+        Event event = { time, sequence_++, kind, service, generation, name };
+        events_.push(event);
+    }
+
+    void start(const Event &event)
+    {
+        Service &service = services_[event.service];
+        Host &host = hosts_[service.host];
+        std::string name = SERVICE_NAME;
+        if (strategy_ != BACKEND_ONLY)
+        {
+            const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+            name = host.registry->reserve(SERVICE_NAME, SERVICE_TYPE, std::string(), getRenameStrategy(), host.id);
+            pickTime_ += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
+            ++picks_;
+        }
+        beginProbe(event.service, name, event.time);
+    }
+
+    void beginProbe(std::size_t index, const std::string &name, std::int64_t now)
+    {
+        Service &service = services_[index];
+        Host &host = hosts_[service.host];
+        service.name = name;
+        if (!host.active.insert(name).second)
+        {
+            // Local duplicate, rejected by the backend after a round trip
+            collision(index, now + 1, false);
+            return;
+        }
+        schedule(now + nextRandom() % 250 + 750, PROBE_DONE, index, name, ++service.generation);
+    }
+
+    void probeDone(const Event &event)
+    {
+        Service &service = services_[event.service];
+        if (event.generation != service.generation)
+            return;
+        if (owners_.count(service.name))
+        {
+            collision(event.service, event.time, true);
+            return;
+        }
+        owners_[service.name] = event.service;
+        ++registered_;
+        for (std::size_t h = 0; h < hosts_.size(); ++h)
+        {
+            if (h != service.host)
+                schedule(event.time + 20 + nextRandom() % 100, VISIBLE, h, service.name);
+        }
+    }
+
+    void visible(const Event &event)
+    {
+        MDNSService service;
+        service.setName(event.name).setType(SERVICE_TYPE).setDomain("local");
+        hosts_[event.service].registry->onNewService(service);
+    }
+
+    void collision(std::size_t index, std::int64_t now, bool active)
+    {
+        Service &service = services_[index];
+        Host &host = hosts_[service.host];
+        ++collisions_;
+        ++service.collisions;
+        if (active)
+            host.active.erase(service.name);
+
+        while (!host.conflicts.empty() && host.conflicts.front() <= now - 10000)
+            host.conflicts.pop_front();
+        host.conflicts.push_back(now);
+        const std::int64_t delay = host.conflicts.size() >= 15 ? 5000 : 0;
+
+        // The backend renames the service and probes again, the resolver
+        // registers it again when the new name is known to be taken
+        std::string newName = backendAlternativeName(service.name);
+        if (strategy_ != BACKEND_ONLY)
+        {
+            const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+            newName = host.registry->resolveCollision(service.name, newName, SERVICE_NAME, SERVICE_TYPE, std::string(),
+                                                      getRenameStrategy(), host.id);
+            pickTime_ += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
+            ++picks_;
+        }
+        schedule(now + delay, PROBE, index, newName);
+    }
+
+    Scenario scenario_;
+    Strategy strategy_;
+    std::uint32_t random_;
+    std::vector<Host> hosts_;
+    std::vector<Service> services_;
+    std::map<std::string, std::size_t> owners_;
+    std::priority_queue<Event> events_;
+    std::uint64_t sequence_ = 0;
+    std::size_t registered_;
+    std::uint64_t collisions_;
+    double pickTime_;
+    std::uint64_t picks_;
+};
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const std::size_t numServices = argc > 1 ? std::strtoul(argv[1], 0, 10) : 200;
+
+    const Scenario scenarios[] = {
+        { numServices, 1, 0 },
+        { numServices, 1, 5000 },
+        { 1, numServices, 0 },
+        { 20, numServices / 20 ? numServices / 20 : 1, 0 }
+    };
+    const Strategy strategies[] = { BACKEND_ONLY, RESOLVER_SEQUENTIAL, RESOLVER_HOST_SUFFIX };
+
+    std::cout << std::setw(6) << "hosts" << std::setw(10) << "per host" << std::setw(8) << "spread"
+              << std::setw(24) << "strategy" << std::setw(14) << "all reg. [s]"
+              << std::setw(12) << "collisions" << std::setw(10) << "max/svc" << std::setw(12) << "pick [us]" << std::endl;
+    for (auto scenario = std::begin(scenarios); scenario != std::end(scenarios); ++scenario)
+    {
+        for (auto strategy = std::begin(strategies); strategy != std::end(strategies); ++strategy)
+        {
+            Simulation simulation(*scenario, *strategy);
+            const Result result = simulation.run();
+            std::cout << std::setw(6) << scenario->hosts << std::setw(10) << scenario->servicesPerHost
+                      << std::setw(8) << scenario->startSpreadMs
+                      << std::setw(24) << toString(*strategy)
+                      << std::setw(14) << std::fixed << std::setprecision(2) << result.timeToAllMs / 1000.0
+                      << std::setw(12) << result.collisions
+                      << std::setw(10) << result.maxCollisionsPerService
+                      << std::setw(12) << std::setprecision(2) << result.pickMicroseconds << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,321 @@
+/*
+ * bench_flat_service.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+// Allocations, time and cache misses per browse event for resolved services
+// stored as MDNSService compared to MDNSFlatService.
+//
+// Every event stores the resolved service in an application map and in the
+// pending changes of a snapshot; every [generation] events a new snapshot of
+// all services is built and the previous one is dropped, then a reader walks
+// the snapshot and looks at name, host and TXT records.
+//
+// MDNSService: map of copies, shared_ptr snapshot entries, vector per generation
+// MDNSFlatService: one allocation per event, shared handles in the same maps
+//                  and in the snapshot, which copies no records
+//
+// Cache misses are read with perf_event_open (Linux), when permitted.
+//
+// Usage: bench_flat_service [services] [events] [generation] [txt records]
+
+#include "MDNSFlatService.hpp"
+#include "MDNSManager.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+
+std::uint64_t allocationCount = 0;
+
+} // namespace
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+// The replaced operators below pair new with free on purpose
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+// Count all heap allocations of the process
+void * operator new(std::size_t size)
+{
+    ++allocationCount;
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+using namespace MDNS;
+
+namespace
+{
+
+/** Hardware cache miss counter of this thread, -1 if unavailable */
+class CacheMissCounter
+{
+public:
+
+    CacheMissCounter()
+        : fd_(-1)
+    {
+#ifdef __linux__
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    ~CacheMissCounter()
+    {
+#ifdef __linux__
+        if (fd_ >= 0)
+            close(fd_);
+#endif
+    }
+
+    bool isAvailable() const { return fd_ >= 0; }
+
+    void start()
+    {
+#ifdef __linux__
+        if (fd_ >= 0)
+        {
+            ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    long long stop()
+    {
+        long long count = -1;
+#ifdef __linux__
+        if (fd_ >= 0)
+        {
+            ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fd_, &count, sizeof(count)) != sizeof(count))
+                count = -1;
+        }
+#endif
+        return count;
+    }
+
+private:
+    int fd_;
+};
+
+struct Measurement
+{
+    double nsPerEvent;
+    double allocationsPerEvent;
+    double cacheMissesPerEvent;
+    std::size_t checksum;
+};
+
+std::vector<MDNSService> makeEvents(std::size_t services, std::size_t events, std::size_t txtRecords)
+{
+    std::vector<MDNSService> result;
+    result.reserve(events);
+    for (std::size_t e = 0; e < events; ++e)
+    {
+        const std::size_t i = (e * 7919) % services;
+        std::ostringstream name, txt;
+        name << "Service instance number " << i;
+        MDNSService service;
+        service.setName(name.str()).setType("_http._tcp").setDomain("local")
+            .setHost("host-" + std::to_string(i % 97) + ".local").setPort(static_cast<unsigned int>(8000 + i % 1000))
+            .setInterfaceIndex(2).addSubtype("_printer");
+        service.addTxtRecord("gen=" + std::to_string(e));
+        for (std::size_t t = 1; t < txtRecords; ++t)
+            service.addTxtRecord("key" + std::to_string(t) + "=some value of a typical length");
+        result.push_back(service);
+    }
+    return result;
+}
+
+template <class Store>
+Measurement measure(const std::vector<MDNSService> &events, std::size_t generation, Store &store)
+{
+    CacheMissCounter counter;
+    const std::uint64_t allocationsBefore = allocationCount;
+    const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    counter.start();
+
+    std::size_t checksum = 0;
+    for (std::size_t e = 0; e < events.size(); ++e)
+    {
+        store.onEvent(events[e]);
+        if ((e + 1) % generation == 0)
+            checksum += store.publishAndRead();
+    }
+
+    const long long misses = counter.stop();
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+    Measurement m;
+    m.nsPerEvent = ns / events.size();
+    m.allocationsPerEvent = static_cast<double>(allocationCount - allocationsBefore) / events.size();
+    m.cacheMissesPerEvent = misses < 0 ? -1.0 : static_cast<double>(misses) / events.size();
+    m.checksum = checksum;
+    return m;
+}
+
+/** Application map and snapshots of MDNSService copies */
+class ServiceStore
+{
+public:
+
+    void onEvent(const MDNSService &service)
+    {
+        services_[service.getName()] = service;
+        pending_[service.getName()] = std::make_shared<const MDNSService>(service);
+    }
+
+    std::size_t publishAndRead()
+    {
+        for (auto it = pending_.begin(), iend = pending_.end(); it != iend; ++it)
+            current_[it->first] = it->second;
+        pending_.clear();
+        std::vector<std::shared_ptr<const MDNSService> > snapshot;
+        snapshot.reserve(current_.size());
+        for (auto it = current_.begin(), iend = current_.end(); it != iend; ++it)
+            snapshot.push_back(it->second);
+        snapshot_.swap(snapshot);
+
+        std::size_t sum = 0;
+        for (auto it = snapshot_.begin(), iend = snapshot_.end(); it != iend; ++it)
+        {
+            const MDNSService &s = **it;
+            sum += s.getName().size() + s.getHost().size();
+            const std::vector<std::string> &txt = s.getTxtRecords();
+            for (auto t = txt.begin(), tend = txt.end(); t != tend; ++t)
+                sum += static_cast<unsigned char>((*t)[0]);
+        }
+        return sum;
+    }
+
+private:
+    std::map<std::string, MDNSService> services_;
+    std::map<std::string, std::shared_ptr<const MDNSService> > pending_;
+    std::map<std::string, std::shared_ptr<const MDNSService> > current_;
+    std::vector<std::shared_ptr<const MDNSService> > snapshot_;
+};
+
+/** Application map, pending changes and snapshots sharing the flat records of the events */
+class FlatStore
+{
+public:
+
+    FlatStore()
+        : snapshot_(new MDNSFlatServiceSet())
+    { }
+
+    void onEvent(const MDNSService &service)
+    {
+        const MDNSFlatService flat(service);
+        services_[service.getName()] = flat;
+        pending_[service.getName()] = flat;
+    }
+
+    std::size_t publishAndRead()
+    {
+        for (auto it = pending_.begin(), iend = pending_.end(); it != iend; ++it)
+            current_[it->first] = it->second;
+        pending_.clear();
+        // Records are shared with current_, the arena of the set stays empty
+        std::unique_ptr<MDNSFlatServiceSet> snapshot(new MDNSFlatServiceSet());
+        snapshot->reserve(current_.size());
+        for (auto it = current_.begin(), iend = current_.end(); it != iend; ++it)
+            snapshot->share(it->second);
+        snapshot->sort();
+        snapshot_.swap(snapshot);
+
+        std::size_t sum = 0;
+        for (auto it = snapshot_->begin(), iend = snapshot_->end(); it != iend; ++it)
+        {
+            sum += it->getName().size() + it->getHost().size();
+            for (std::size_t t = 0, n = it->getTxtRecordCount(); t < n; ++t)
+                sum += static_cast<unsigned char>(it->getTxtRecord(t)[0]);
+        }
+        return sum;
+    }
+
+private:
+    std::map<std::string, MDNSFlatService> services_;
+    std::map<std::string, MDNSFlatService> pending_;
+    std::map<std::string, MDNSFlatService> current_;
+    std::unique_ptr<MDNSFlatServiceSet> snapshot_;
+};
+
+void print(const char *label, const Measurement &m)
+{
+    std::cout << std::setw(18) << label
+              << std::setw(12) << std::fixed << std::setprecision(1) << m.nsPerEvent
+              << std::setw(14) << std::setprecision(2) << m.allocationsPerEvent;
+    if (m.cacheMissesPerEvent < 0)
+        std::cout << std::setw(16) << "n/a";
+    else
+        std::cout << std::setw(16) << std::setprecision(1) << m.cacheMissesPerEvent;
+    std::cout << "   (checksum " << m.checksum << ")" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const std::size_t numServices = argc > 1 ? std::strtoul(argv[1], 0, 10) : 5000;
+    const std::size_t numEvents = argc > 2 ? std::strtoul(argv[2], 0, 10) : 200000;
+    const std::size_t generation = argc > 3 ? std::strtoul(argv[3], 0, 10) : 1000;
+    const std::size_t txtRecords = argc > 4 ? std::strtoul(argv[4], 0, 10) : 4;
+
+    const std::vector<MDNSService> events = makeEvents(numServices, numEvents, txtRecords);
+    std::cout << "services: " << numServices << ", events: " << numEvents << ", snapshot every "
+              << generation << " events, TXT records: " << txtRecords << std::endl;
+    std::cout << std::setw(18) << "representation" << std::setw(12) << "ns/event"
+              << std::setw(14) << "allocs/event" << std::setw(16) << "misses/event" << std::endl;
+
+    {
+        ServiceStore store;
+        print("MDNSService", measure(events, generation, store));
+    }
+    {
+        FlatStore store;
+        print("MDNSFlatService", measure(events, generation, store));
+    }
+    if (!CacheMissCounter().isAvailable())
+        std::cout << "cache misses: perf_event_open not permitted (see kernel.perf_event_paranoid)" << std::endl;
+    return 0;
+}
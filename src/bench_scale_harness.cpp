@@ -0,0 +1,574 @@
+/*
+ * bench_scale_harness.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+// Thousands of simulated publishers and a few browsers in one process, on
+// loopback without network: native responders and browsers exchange packets
+// through MDNSLoopbackReflector, which stands in for the multicast group.
+//
+// The harness publishes all services, lets the browsers discover them, then
+// removes and re-adds random services at the churn rate. It reports CPU time,
+// RSS, latency percentiles of discovery, add and remove events and, after
+// the settle time, missed, stale and duplicate events per browser.
+//
+// With join=late the browsers start only after the population is published
+// and settled, like a client starting on a busy network. Time to first and
+// to 95% discovered are then measured from the browser start, which is where
+// the browser profiles differ: standard (RFC 6762 defaults), qu (first query
+// asks for unicast responses) and burst (MDNSNativeBrowser::Options::startupBurst).
+//
+// Usage: bench_scale_harness [key=value ...]
+//   publishers=5000 responders=4 browsers=2 txt=100 ttl=120
+//   churn=50 (removals per second) downtime=500 (ms until re-added)
+//   duration=10 (s of churn) settle=3 (s)
+//   delay=20-120 (ms response delay of responders)
+//   udelay=0-10 (ms delay of unicast responses)
+//   join=early|late profile=standard|qu|burst
+
+#include "MDNSLoopbackReflector.hpp"
+#include "MDNSManager.hpp"
+#include "MDNSNativeBrowser.hpp"
+#include "MDNSNativeResponder.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/resource.h>
+
+using namespace MDNS;
+
+namespace
+{
+
+typedef std::chrono::steady_clock Clock;
+
+const char * const SERVICE_TYPE = "_harness._tcp";
+
+struct Config
+{
+    std::size_t publishers = 5000;
+    std::size_t responders = 4;
+    std::size_t browsers = 2;
+    std::size_t txtSize = 100;
+    std::uint32_t ttl = 120;
+    double churn = 50;
+    std::chrono::milliseconds downtime{500};
+    std::chrono::seconds duration{10};
+    std::chrono::seconds settle{3};
+    std::chrono::milliseconds minResponseDelay{20};
+    std::chrono::milliseconds maxResponseDelay{120};
+    std::chrono::milliseconds minUnicastResponseDelay{0};
+    std::chrono::milliseconds maxUnicastResponseDelay{10};
+    bool lateJoin = false;
+    std::string profile = "standard";
+
+    static void parseRange(const std::string &value, std::chrono::milliseconds &min, std::chrono::milliseconds &max)
+    {
+        const std::size_t dash = value.find('-');
+        min = std::chrono::milliseconds(std::atoll(value.c_str()));
+        max = dash == std::string::npos ? min : std::chrono::milliseconds(std::atoll(value.c_str() + dash + 1));
+    }
+
+    bool parse(const std::string &arg)
+    {
+        const std::size_t eq = arg.find('=');
+        if (eq == std::string::npos)
+            return false;
+        const std::string key = arg.substr(0, eq);
+        const std::string value = arg.substr(eq + 1);
+        const long long n = std::atoll(value.c_str());
+        if (key == "publishers") publishers = n;
+        else if (key == "responders") responders = n > 0 ? n : 1;
+        else if (key == "browsers") browsers = n;
+        else if (key == "txt") txtSize = n;
+        else if (key == "ttl") ttl = static_cast<std::uint32_t>(n);
+        else if (key == "churn") churn = std::atof(value.c_str());
+        else if (key == "downtime") downtime = std::chrono::milliseconds(n);
+        else if (key == "duration") duration = std::chrono::seconds(n);
+        else if (key == "settle") settle = std::chrono::seconds(n);
+        else if (key == "delay") parseRange(value, minResponseDelay, maxResponseDelay);
+        else if (key == "udelay") parseRange(value, minUnicastResponseDelay, maxUnicastResponseDelay);
+        else if (key == "join" && (value == "early" || value == "late")) lateJoin = value == "late";
+        else if (key == "profile" && (value == "standard" || value == "qu" || value == "burst")) profile = value;
+        else
+            return false;
+        return true;
+    }
+};
+
+/** What the publishers currently announce */
+class Truth
+{
+public:
+
+    struct Entry
+    {
+        std::uint32_t generation;
+        bool present;
+        Clock::time_point addedAt;
+        Clock::time_point removedAt;
+    };
+
+    void add(const std::string &name, std::uint32_t generation, Clock::time_point now)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Entry &entry = entries_[name];
+        entry.generation = generation;
+        entry.present = true;
+        entry.addedAt = now;
+    }
+
+    void remove(const std::string &name, Clock::time_point now)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Entry &entry = entries_[name];
+        entry.present = false;
+        entry.removedAt = now;
+    }
+
+    bool get(const std::string &name, Entry &entry) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(name);
+        if (it == entries_.end())
+            return false;
+        entry = it->second;
+        return true;
+    }
+
+    std::unordered_map<std::string, Entry> getAll() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return entries_;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;
+};
+
+std::uint32_t getGeneration(const MDNSService &service)
+{
+    const std::vector<std::string> &txt = service.getTxtRecords();
+    for (auto it = txt.begin(), iend = txt.end(); it != iend; ++it)
+    {
+        if (it->compare(0, 4, "gen=") == 0)
+            return static_cast<std::uint32_t>(std::strtoul(it->c_str() + 4, 0, 10));
+    }
+    return 0;
+}
+
+/** Checks every event against the truth and records its latency */
+class MeasuringBrowser : public MDNSServiceBrowser
+{
+public:
+
+    struct Result
+    {
+        std::vector<double> discoveryMs;
+        std::vector<double> addMs;
+        std::vector<double> removeMs;
+        std::uint64_t duplicateAdds = 0;
+        std::uint64_t duplicateRemoves = 0;
+        std::uint64_t outdated = 0;
+        /** Discovery times of the initial population, relative to the browser start */
+        std::vector<double> initialDiscoveryMs;
+        std::unordered_map<std::string, std::uint32_t> known;
+    };
+
+    MeasuringBrowser(const Truth &truth, Clock::time_point start)
+        : truth_(truth), start_(start)
+    { }
+
+    void onNewService(const MDNSService &service) override
+    {
+        const Clock::time_point now = Clock::now();
+        const std::uint32_t generation = getGeneration(service);
+        Truth::Entry entry;
+        const bool inTruth = truth_.get(service.getName(), entry);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = result_.known.find(service.getName());
+        if (it != result_.known.end() && it->second == generation)
+        {
+            ++result_.duplicateAdds;
+            return;
+        }
+        result_.known[service.getName()] = generation;
+        if (!inTruth || !entry.present || entry.generation != generation)
+        {
+            ++result_.outdated;
+            return;
+        }
+        const double latency = toMs(now - std::max(entry.addedAt, start_));
+        if (generation == 1)
+        {
+            result_.discoveryMs.push_back(latency);
+            result_.initialDiscoveryMs.push_back(toMs(now - start_));
+        }
+        else
+            result_.addMs.push_back(latency);
+    }
+
+    void onRemovedService(const std::string &name, const std::string &type, const std::string &domain, MDNSInterfaceIndex interfaceIndex) override
+    {
+        (void)type;
+        (void)domain;
+        (void)interfaceIndex;
+        const Clock::time_point now = Clock::now();
+        Truth::Entry entry;
+        const bool inTruth = truth_.get(name, entry);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (result_.known.erase(name) == 0)
+        {
+            ++result_.duplicateRemoves;
+            return;
+        }
+        if (inTruth && entry.removedAt != Clock::time_point())
+            result_.removeMs.push_back(toMs(now - entry.removedAt));
+    }
+
+    Result getResult() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return result_;
+    }
+
+    static double toMs(Clock::duration d)
+    {
+        return std::chrono::duration<double, std::milli>(d).count();
+    }
+
+private:
+    const Truth &truth_;
+    Clock::time_point start_;
+    mutable std::mutex mutex_;
+    Result result_;
+};
+
+std::string percentiles(std::vector<double> samples)
+{
+    std::ostringstream s;
+    if (samples.empty())
+        return "n/a";
+    std::sort(samples.begin(), samples.end());
+    auto at = [&samples](double p)
+    {
+        return samples[std::min(samples.size() - 1, static_cast<std::size_t>(p * samples.size()))];
+    };
+    s << std::fixed << std::setprecision(1)
+      << "n=" << samples.size() << " p50=" << at(0.5) << " p90=" << at(0.9)
+      << " p99=" << at(0.99) << " max=" << samples.back() << " ms";
+    return s.str();
+}
+
+/** VmRSS and VmHWM in kB */
+std::pair<long, long> getMemoryUsage()
+{
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    long rss = 0, hwm = 0;
+    while (std::getline(status, line))
+    {
+        if (line.compare(0, 6, "VmRSS:") == 0)
+            rss = std::atol(line.c_str() + 6);
+        else if (line.compare(0, 6, "VmHWM:") == 0)
+            hwm = std::atol(line.c_str() + 6);
+    }
+    return std::make_pair(rss, hwm);
+}
+
+double getProcessCpuSeconds()
+{
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+std::string makeName(std::size_t i)
+{
+    std::ostringstream name;
+    name << "Publisher " << std::setw(5) << std::setfill('0') << i;
+    return name.str();
+}
+
+MDNSService makeService(const Config &config, std::size_t i, std::uint32_t generation)
+{
+    MDNSService service;
+    std::ostringstream gen;
+    gen << "gen=" << generation;
+    service.setName(makeName(i)).setType(SERVICE_TYPE).setDomain("local")
+        .setPort(static_cast<unsigned int>(10000 + i % 50000)).addTxtRecord(gen.str());
+    // Pad the TXT data to the configured size
+    std::size_t size = gen.str().size() + 1;
+    while (size + 4 < config.txtSize)
+    {
+        const std::size_t chunk = std::min<std::size_t>(config.txtSize - size - 4, 200);
+        service.addTxtRecord("pad=" + std::string(chunk, 'x'));
+        size += chunk + 5;
+    }
+    return service;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Config config;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!config.parse(argv[i]))
+        {
+            std::cerr << "Unknown argument " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "publishers " << config.publishers << ", responders " << config.responders
+              << ", browsers " << config.browsers << ", txt " << config.txtSize << " bytes, ttl " << config.ttl
+              << " s, churn " << config.churn << "/s, downtime " << config.downtime.count()
+              << " ms, duration " << config.duration.count() << " s, response delay "
+              << config.minResponseDelay.count() << "-" << config.maxResponseDelay.count() << " ms, unicast "
+              << config.minUnicastResponseDelay.count() << "-" << config.maxUnicastResponseDelay.count() << " ms, join "
+              << (config.lateJoin ? "late" : "early") << ", profile " << config.profile << std::endl;
+
+    const std::pair<long, long> memoryBefore = getMemoryUsage();
+    const double cpuBefore = getProcessCpuSeconds();
+    std::string error;
+
+    MDNSLoopbackReflector reflector;
+    if (!reflector.start(&error))
+    {
+        std::cerr << "ERROR " << error << std::endl;
+        return 1;
+    }
+
+    MDNSNativeSocket::Options socketOptions;
+    socketOptions.bindAddress = "127.0.0.1";
+    socketOptions.receiveBufferSize = 4 * 1024 * 1024;
+
+    MDNSNativeResponder::Options responderOptions;
+    responderOptions.destination = reflector.getEndpoint();
+    responderOptions.hostName = "harness.local";
+    responderOptions.ttl = config.ttl;
+    responderOptions.minResponseDelay = config.minResponseDelay;
+    responderOptions.maxResponseDelay = config.maxResponseDelay;
+    responderOptions.minUnicastResponseDelay = config.minUnicastResponseDelay;
+    responderOptions.maxUnicastResponseDelay = config.maxUnicastResponseDelay;
+
+    std::vector<std::unique_ptr<MDNSNativeResponder> > responders;
+    for (std::size_t i = 0; i < config.responders; ++i)
+    {
+        responders.emplace_back(new MDNSNativeResponder(responderOptions));
+        if (!responders.back()->start(socketOptions, &error) ||
+            !reflector.addMember(responders.back()->getLocalEndpoint(), &error))
+        {
+            std::cerr << "ERROR " << error << std::endl;
+            return 1;
+        }
+    }
+
+    Truth truth;
+    const Clock::time_point start = Clock::now();
+
+    MDNSNativeBrowser::Options browserOptions;
+    if (config.profile == "burst")
+        browserOptions = MDNSNativeBrowser::Options::startupBurst();
+    else if (config.profile == "qu")
+        browserOptions.unicastQueries = 1;
+    browserOptions.destination = reflector.getEndpoint();
+    std::vector<std::shared_ptr<MeasuringBrowser> > measuring;
+    std::vector<std::unique_ptr<MDNSNativeBrowser> > browsers;
+    auto startBrowsers = [&]() -> bool
+    {
+        const Clock::time_point browserStart = Clock::now();
+        for (std::size_t i = 0; i < config.browsers; ++i)
+        {
+            measuring.push_back(std::make_shared<MeasuringBrowser>(truth, browserStart));
+            browsers.emplace_back(new MDNSNativeBrowser(measuring.back(), SERVICE_TYPE, "local", browserOptions));
+            if (!browsers.back()->start(socketOptions, &error) ||
+                !reflector.addMember(browsers.back()->getLocalEndpoint(), &error))
+            {
+                std::cerr << "ERROR " << error << std::endl;
+                return false;
+            }
+        }
+        return true;
+    };
+    if (!config.lateJoin && !startBrowsers())
+        return 1;
+
+    // Publish everything at once
+    std::vector<std::uint32_t> generations(config.publishers, 1);
+    for (std::size_t i = 0; i < config.publishers; ++i)
+    {
+        truth.add(makeName(i), 1, Clock::now());
+        responders[i % responders.size()]->addService(makeService(config, i, 1));
+    }
+
+    // Let the initial announcements and queries settle before churning
+    std::this_thread::sleep_for(config.settle);
+    std::cout << "initial population published and settled after "
+              << std::fixed << std::setprecision(2) << MeasuringBrowser::toMs(Clock::now() - start) / 1000.0 << " s" << std::endl;
+    if (config.lateJoin)
+    {
+        if (!startBrowsers())
+            return 1;
+        std::this_thread::sleep_for(config.settle);
+    }
+
+    // Churn: remove random present services, re-add them after the downtime
+    std::mt19937 random(42);
+    std::deque<std::pair<Clock::time_point, std::size_t> > readd;
+    std::vector<bool> present(config.publishers, true);
+    const Clock::time_point churnEnd = Clock::now() + config.duration;
+    const std::chrono::microseconds churnInterval(config.churn > 0 ? static_cast<std::int64_t>(1e6 / config.churn) : 0);
+    Clock::time_point nextRemoval = Clock::now();
+    std::uint64_t removals = 0;
+    while (Clock::now() < churnEnd && config.publishers > 0)
+    {
+        const Clock::time_point now = Clock::now();
+        while (!readd.empty() && readd.front().first <= now)
+        {
+            const std::size_t i = readd.front().second;
+            readd.pop_front();
+            ++generations[i];
+            present[i] = true;
+            truth.add(makeName(i), generations[i], Clock::now());
+            responders[i % responders.size()]->addService(makeService(config, i, generations[i]));
+        }
+        if (churnInterval.count() > 0 && now >= nextRemoval)
+        {
+            const std::size_t i = random() % config.publishers;
+            if (present[i])
+            {
+                present[i] = false;
+                truth.remove(makeName(i), Clock::now());
+                responders[i % responders.size()]->removeService(makeName(i), SERVICE_TYPE, "local");
+                readd.push_back(std::make_pair(now + config.downtime, i));
+                ++removals;
+            }
+            nextRemoval += churnInterval;
+        }
+        Clock::time_point wakeup = now + std::chrono::milliseconds(10);
+        if (!readd.empty())
+            wakeup = std::min(wakeup, readd.front().first);
+        if (churnInterval.count() > 0)
+            wakeup = std::min(wakeup, nextRemoval);
+        std::this_thread::sleep_until(wakeup);
+    }
+    // Re-add what is still down and let the browsers catch up
+    while (!readd.empty())
+    {
+        std::this_thread::sleep_until(readd.front().first);
+        const std::size_t i = readd.front().second;
+        readd.pop_front();
+        ++generations[i];
+        truth.add(makeName(i), generations[i], Clock::now());
+        responders[i % responders.size()]->addService(makeService(config, i, generations[i]));
+    }
+    std::this_thread::sleep_for(config.settle);
+
+    const double cpuSeconds = getProcessCpuSeconds() - cpuBefore;
+    const double wallSeconds = MeasuringBrowser::toMs(Clock::now() - start) / 1000.0;
+    const std::pair<long, long> memory = getMemoryUsage();
+
+    for (auto it = browsers.begin(), iend = browsers.end(); it != iend; ++it)
+        (*it)->stop();
+    for (auto it = responders.begin(), iend = responders.end(); it != iend; ++it)
+        (*it)->stop();
+    reflector.stop();
+
+    std::cout << "removals " << removals << ", wall " << std::setprecision(2) << wallSeconds
+              << " s, process cpu " << cpuSeconds << " s (" << std::setprecision(1) << 100.0 * cpuSeconds / wallSeconds
+              << "%), rss " << memory.first / 1024 << " MiB (before " << memoryBefore.first / 1024
+              << " MiB, peak " << memory.second / 1024 << " MiB)" << std::endl;
+
+    MDNSNativeResponder::Stats responderStats;
+    for (auto it = responders.begin(), iend = responders.end(); it != iend; ++it)
+    {
+        const MDNSNativeResponder::Stats stats = (*it)->getStats();
+        responderStats.queriesReceived += stats.queriesReceived;
+        responderStats.packetsSent += stats.packetsSent;
+        responderStats.recordsSent += stats.recordsSent;
+        responderStats.suppressedAnswers += stats.suppressedAnswers;
+        responderStats.unicastQuestionsReceived += stats.unicastQuestionsReceived;
+        responderStats.unicastPacketsSent += stats.unicastPacketsSent;
+    }
+    const MDNSLoopbackReflector::Stats reflectorStats = reflector.getStats();
+    std::cout << "responders: queries " << responderStats.queriesReceived << ", packets " << responderStats.packetsSent
+              << ", records " << responderStats.recordsSent << ", suppressed answers " << responderStats.suppressedAnswers
+              << ", QU questions " << responderStats.unicastQuestionsReceived << ", unicast packets " << responderStats.unicastPacketsSent
+              << "; reflector: packets " << reflectorStats.packetsReceived << ", forwarded " << reflectorStats.packetsForwarded
+              << " (unicast " << reflectorStats.unicastForwarded << ")"
+              << std::endl;
+
+    const std::unordered_map<std::string, Truth::Entry> expected = truth.getAll();
+    int failures = 0;
+    for (std::size_t b = 0; b < browsers.size(); ++b)
+    {
+        const MDNSNativeBrowser::Stats stats = browsers[b]->getStats();
+        const MeasuringBrowser::Result result = measuring[b]->getResult();
+
+        std::size_t missed = 0, stale = 0;
+        for (auto it = expected.begin(), iend = expected.end(); it != iend; ++it)
+        {
+            auto found = result.known.find(it->first);
+            if (it->second.present && (found == result.known.end() || found->second != it->second.generation))
+                ++missed;
+        }
+        for (auto it = result.known.begin(), iend = result.known.end(); it != iend; ++it)
+        {
+            auto found = expected.find(it->first);
+            if (found == expected.end() || !found->second.present || found->second.generation != it->second)
+                ++stale;
+        }
+
+        std::vector<double> initial = result.initialDiscoveryMs;
+        std::sort(initial.begin(), initial.end());
+        const std::size_t n = config.publishers;
+        auto timeTo = [&initial, n](double fraction) -> std::string
+        {
+            const std::size_t needed = std::max<std::size_t>(1, static_cast<std::size_t>(fraction * n + 0.5));
+            std::ostringstream s;
+            if (initial.size() < needed)
+                s << "never";
+            else
+                s << std::fixed << std::setprecision(1) << initial[needed - 1] << " ms";
+            return s.str();
+        };
+
+        std::cout << "browser " << b << ": cpu " << std::setprecision(3) << stats.cpuTime.count() / 1e6
+                  << " s, queries " << stats.queriesSent << ", packets " << stats.packetsReceived
+                  << " (unicast " << stats.unicastPacketsReceived << ")"
+                  << ", records " << stats.recordsReceived << ", added " << stats.servicesAdded
+                  << ", removed " << stats.servicesRemoved << std::endl;
+        std::cout << "  time to first " << timeTo(0.0) << ", to 50% " << timeTo(0.5)
+                  << ", to 95% " << timeTo(0.95) << ", to 100% " << timeTo(1.0) << std::endl;
+        std::cout << "  discovery " << percentiles(result.discoveryMs) << std::endl;
+        std::cout << "  add       " << percentiles(result.addMs) << std::endl;
+        std::cout << "  remove    " << percentiles(result.removeMs) << std::endl;
+        std::cout << "  missed " << missed << ", stale " << stale << ", duplicate adds " << result.duplicateAdds
+                  << ", duplicate removes " << result.duplicateRemoves << ", outdated " << result.outdated << std::endl;
+        if (missed || stale)
+            ++failures;
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,123 @@
+/*
+ * bench_service_selector.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+// Cost of MDNSServiceSelector::pick() per call, and of publishing a change of
+// one instance depending on the number of instances and subtypes of the type.
+// Only the table of the type and the tables of the subtypes of the changed
+// instance are rebuilt.
+//
+// Usage: bench_service_selector [max instances] [subtypes] [picks]
+
+#include "MDNSManager.hpp"
+#include "MDNSServiceSelector.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace MDNS;
+
+namespace
+{
+
+typedef std::chrono::steady_clock Clock;
+
+/** Instance i announces subtype i % numSubtypes */
+MDNSService makeService(std::size_t i, std::size_t numSubtypes, unsigned int weight)
+{
+    std::ostringstream name, subtype, txt;
+    name << "Service " << i;
+    txt << "weight=" << weight;
+    MDNSService service;
+    service.setName(name.str()).setType("_http._tcp").setDomain("local")
+        .setHost("host.local").setPort(8080).addTxtRecord(txt.str());
+    if (numSubtypes != 0)
+    {
+        subtype << "_sub" << i % numSubtypes;
+        service.addSubtype(subtype.str());
+    }
+    return service;
+}
+
+double nsPer(Clock::duration elapsed, std::size_t count)
+{
+    return std::chrono::duration<double, std::nano>(elapsed).count() / count;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const std::size_t maxInstances = argc > 1 ? std::strtoul(argv[1], 0, 10) : 10000;
+    const std::size_t numSubtypes = argc > 2 ? std::strtoul(argv[2], 0, 10) : 16;
+    const std::size_t numPicks = argc > 3 ? std::strtoul(argv[3], 0, 10) : 1000000;
+    const std::size_t numUpdates = 200;
+
+    std::cout << "subtypes: " << numSubtypes << ", picks: " << numPicks << ", updates: " << numUpdates << std::endl;
+    std::cout << std::setw(10) << "instances"
+              << std::setw(14) << "pick ns"
+              << std::setw(14) << "pick+copy ns"
+              << std::setw(18) << "subtype pick ns"
+              << std::setw(16) << "update us" << std::endl;
+
+    for (std::size_t numInstances = 10; numInstances <= maxInstances; numInstances *= 10)
+    {
+        MDNSServiceSelector::Options options;
+        options.maxPendingChanges = static_cast<std::size_t>(-1);
+        options.maxDelay = Clock::duration::max();
+        MDNSServiceSelector selector(options);
+        for (std::size_t i = 0; i < numInstances; ++i)
+            selector.onNewService(makeService(i, numSubtypes, static_cast<unsigned int>(1 + i % 10)));
+        selector.flush();
+
+        std::uint64_t checksum = 0;
+        Clock::time_point start = Clock::now();
+        {
+            MDNSEpochDomain::ReadGuard guard(selector.getDomain());
+            for (std::size_t i = 0; i < numPicks; ++i)
+                checksum += selector.pick(guard, "_http._tcp")->getPort();
+        }
+        const double pickNs = nsPer(Clock::now() - start, numPicks);
+
+        MDNSService copy;
+        start = Clock::now();
+        for (std::size_t i = 0; i < numPicks / 10; ++i)
+        {
+            selector.pick("_http._tcp", copy);
+            checksum += copy.getPort();
+        }
+        const double copyNs = nsPer(Clock::now() - start, numPicks / 10);
+
+        const std::string subtype = numSubtypes != 0 ? "_sub0" : "";
+        start = Clock::now();
+        {
+            MDNSEpochDomain::ReadGuard guard(selector.getDomain());
+            for (std::size_t i = 0; i < numPicks; ++i)
+                checksum += selector.pick(guard, "_http._tcp", subtype)->getPort();
+        }
+        const double subtypeNs = nsPer(Clock::now() - start, numPicks);
+
+        // Weight change of one instance, each published on its own
+        start = Clock::now();
+        for (std::size_t i = 0; i < numUpdates; ++i)
+        {
+            selector.onNewService(makeService(i % numInstances, numSubtypes, static_cast<unsigned int>(2 + i % 7)));
+            selector.flush();
+        }
+        const double updateUs = nsPer(Clock::now() - start, numUpdates) / 1000.0;
+
+        std::cout << std::setw(10) << numInstances
+                  << std::setw(14) << std::fixed << std::setprecision(1) << pickNs
+                  << std::setw(14) << copyNs
+                  << std::setw(18) << subtypeNs
+                  << std::setw(16) << updateUs
+                  << (checksum == 0 ? " " : "") << std::endl;
+    }
+}
@@ -0,0 +1,216 @@
+/*
+ * bench_snapshot_lookup.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+// Lookup throughput of MDNSSnapshotBrowser with multiple reader threads while
+// the writer continuously removes and re-adds services, compared to a map
+// protected by a mutex.
+//
+// Usage: bench_snapshot_lookup [services] [milliseconds per run] [max threads]
+
+#include "MDNSManager.hpp"
+#include "MDNSServiceSnapshot.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+using namespace MDNS;
+
+namespace
+{
+
+struct Names
+{
+    std::vector<std::string> names;
+    std::string type;
+    std::string domain;
+};
+
+inline std::uint32_t xorshift(std::uint32_t &state)
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+MDNSService makeService(const Names &names, std::size_t i, unsigned int port)
+{
+    MDNSService service;
+    service.setName(names.names[i]).setType(names.type).setDomain(names.domain)
+        .setHost("host.local").setPort(port).addTxtRecord("path=/foobar");
+    return service;
+}
+
+class MutexMap
+{
+public:
+    typedef std::tuple<std::string, std::string, std::string, MDNSInterfaceIndex> Key;
+
+    void add(const MDNSService &service)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        map_[Key(service.getType(), service.getName(), service.getDomain(), service.getInterfaceIndex())] = service;
+    }
+
+    void remove(const MDNSService &service)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        map_.erase(Key(service.getType(), service.getName(), service.getDomain(), service.getInterfaceIndex()));
+    }
+
+    unsigned int getPort(const Key &key)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = map_.find(key);
+        return it == map_.end() ? 0 : it->second.getPort();
+    }
+
+private:
+    std::mutex mutex_;
+    std::map<Key, MDNSService> map_;
+};
+
+template <class Reader, class Writer>
+double measure(unsigned int numThreads, std::chrono::milliseconds duration, Reader reader, Writer writer)
+{
+    std::atomic<bool> stop(false);
+    std::vector<std::uint64_t> counts(numThreads * 8, 0);
+    std::vector<std::thread> threads;
+
+    std::thread writerThread([&]() { writer(stop); });
+    for (unsigned int t = 0; t < numThreads; ++t)
+    {
+        threads.push_back(std::thread([&, t]()
+        {
+            std::uint32_t rng = 2463534242u + t * 7919u;
+            std::uint64_t count = 0;
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                for (int i = 0; i < 256; ++i)
+                    reader(xorshift(rng));
+                count += 256;
+            }
+            counts[t * 8] = count;
+        }));
+    }
+
+    std::this_thread::sleep_for(duration);
+    stop = true;
+    for (auto it = threads.begin(), iend = threads.end(); it != iend; ++it)
+        it->join();
+    writerThread.join();
+
+    std::uint64_t total = 0;
+    for (unsigned int t = 0; t < numThreads; ++t)
+        total += counts[t * 8];
+    return total / std::chrono::duration<double>(duration).count();
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const std::size_t numServices = argc > 1 ? std::strtoul(argv[1], 0, 10) : 5000;
+    const std::chrono::milliseconds duration(argc > 2 ? std::atoi(argv[2]) : 1000);
+    unsigned int maxThreads = argc > 3 ? std::atoi(argv[3]) : std::thread::hardware_concurrency();
+    if (maxThreads < 2)
+        maxThreads = 2;
+
+    Names names;
+    names.type = "_http._tcp";
+    names.domain = "local";
+    for (std::size_t i = 0; i < numServices; ++i)
+    {
+        std::ostringstream name;
+        name << "Service " << i;
+        names.names.push_back(name.str());
+    }
+
+    // Writer thread is one of the cores, readers use the rest
+    std::cout << "services: " << numServices << ", run: " << duration.count() << " ms, churn: continuous"
+              << std::endl;
+    std::cout << std::setw(8) << "readers"
+              << std::setw(18) << "snapshot ops/s" << std::setw(10) << "scaling"
+              << std::setw(18) << "mutex ops/s" << std::setw(10) << "scaling"
+              << std::setw(12) << "publishes" << std::endl;
+
+    double snapshotBase = 0, mutexBase = 0;
+    for (unsigned int numThreads = 1; numThreads < maxThreads; numThreads *= 2)
+    {
+        MDNSSnapshotBrowser snapshot(64, std::chrono::milliseconds(5));
+        MutexMap mutexMap;
+        for (std::size_t i = 0; i < numServices; ++i)
+        {
+            snapshot.onNewService(makeService(names, i, 1000));
+            mutexMap.add(makeService(names, i, 1000));
+        }
+        snapshot.flush();
+
+        const double snapshotOps = measure(numThreads, duration,
+            [&](std::uint32_t r)
+            {
+                const std::string &name = names.names[r % numServices];
+                MDNSEpochDomain::ReadGuard guard(snapshot.getDomain());
+                const MDNSService *service = snapshot.getSnapshot(guard)->find(name, names.type, names.domain, MDNS_IF_ANY);
+                volatile unsigned int port = service ? service->getPort() : 0;
+                (void)port;
+            },
+            [&](std::atomic<bool> &stop)
+            {
+                std::uint32_t rng = 88172645u;
+                unsigned int port = 2000;
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    const std::size_t i = xorshift(rng) % numServices;
+                    snapshot.onRemovedService(names.names[i], names.type, names.domain, MDNS_IF_ANY);
+                    snapshot.onNewService(makeService(names, i, ++port));
+                }
+                snapshot.flush();
+            });
+
+        const double mutexOps = measure(numThreads, duration,
+            [&](std::uint32_t r)
+            {
+                const MutexMap::Key key(names.type, names.names[r % numServices], names.domain, MDNS_IF_ANY);
+                volatile unsigned int port = mutexMap.getPort(key);
+                (void)port;
+            },
+            [&](std::atomic<bool> &stop)
+            {
+                std::uint32_t rng = 88172645u;
+                unsigned int port = 2000;
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    const std::size_t i = xorshift(rng) % numServices;
+                    MDNSService service = makeService(names, i, ++port);
+                    mutexMap.remove(service);
+                    mutexMap.add(service);
+                }
+            });
+
+        if (numThreads == 1)
+        {
+            snapshotBase = snapshotOps;
+            mutexBase = mutexOps;
+        }
+
+        std::cout << std::setw(8) << numThreads
+                  << std::setw(18) << std::fixed << std::setprecision(0) << snapshotOps
+                  << std::setw(10) << std::setprecision(2) << snapshotOps / snapshotBase
+                  << std::setw(18) << std::setprecision(0) << mutexOps
+                  << std::setw(10) << std::setprecision(2) << mutexOps / mutexBase
+                  << std::setw(12) << snapshot.getStats().publishes << std::endl;
+    }
+}
@@ -0,0 +1,127 @@
+/*
+ * test_flat_service.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include "MDNSFlatService.hpp"
+#include "MDNSManager.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace MDNS;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string &what)
+{
+    if (!condition)
+    {
+        std::cerr<<"FAILED: "<<what<<std::endl;
+        ++failures;
+    }
+}
+
+static MDNSService makeService(const std::string &name, const std::string &type, MDNSInterfaceIndex interfaceIndex = 2)
+{
+    MDNSService service;
+    service.setName(name).setType(type).setDomain("local").setHost("host.local").setPort(8080)
+        .setInterfaceIndex(interfaceIndex).addSubtype("_printer")
+        .addTxtRecord("Path=/index.html").addTxtRecord("flag").addTxtRecord("path=/other");
+    return service;
+}
+
+/** Same fields as the service it was made of */
+static bool matches(const MDNSFlatService &flat, const MDNSService &service)
+{
+    const MDNSService copy = flat.toService();
+    return copy.getName() == service.getName() && copy.getType() == service.getType() &&
+        copy.getDomain() == service.getDomain() && copy.getHost() == service.getHost() &&
+        copy.getPort() == service.getPort() && copy.getInterfaceIndex() == service.getInterfaceIndex() &&
+        copy.getSubtypes() == service.getSubtypes() && copy.getTxtRecords() == service.getTxtRecords();
+}
+
+int main()
+{
+    const MDNSService service = makeService("Printer", "_ipp._tcp");
+
+    // Heap and arena blocks
+    const MDNSFlatService heap(service);
+    check(!heap.isNull() && !heap.isArenaAllocated(), "heap block");
+    check(matches(heap, service), "heap block holds all fields");
+    check(heap.getByteSize() % 8 == 0, "block size is aligned");
+
+    MDNSServiceArena::Ptr arena = MDNSServiceArena::create(256);
+    {
+        const MDNSFlatService inArena(service, *arena);
+        check(inArena.isArenaAllocated(), "arena block");
+        check(matches(inArena, service), "arena block holds all fields");
+        check(arena->getUsedBytes() == inArena.getByteSize(), "arena hands out the block size");
+        const MDNSFlatService copy(inArena);
+        check(copy.getName().data() == inArena.getName().data(), "copies share the block");
+    }
+    check(arena->getChunkCount() == 1, "arena keeps its chunk until released");
+
+    // Copy of a heap block into an arena
+    {
+        const MDNSFlatService copied(heap, *arena);
+        check(copied.isArenaAllocated(), "copy into the arena is arena allocated");
+        check(copied.getByteSize() == heap.getByteSize(), "copy into the arena has the same size");
+        check(copied.getName().data() != heap.getName().data(), "copy into the arena has its own block");
+        check(matches(copied, service), "copy into the arena holds all fields");
+        check(arena->getChunkCount() == 2, "block larger than the rest of the chunk gets a new chunk");
+    }
+    const MDNSFlatService nullCopy(MDNSFlatService(), *arena);
+    check(nullCopy.isNull(), "copy of a null service into the arena is null");
+
+    // TXT values, RFC 6763 section 6.4
+    MDNSStringRef value;
+    check(heap.findTxtValue("PATH", value) && value == "/index.html", "keys are case-insensitive, first one wins");
+    check(heap.findTxtValue("Flag", value) && value.empty(), "key without value");
+    check(!heap.findTxtValue("missing", value), "missing key");
+    check(!heap.findTxtValue("pat", value), "prefix of a key does not match");
+
+    // Copies outlive their set
+    MDNSFlatService survivor;
+    {
+        MDNSFlatServiceSet set(128);
+        set.add(makeService("B", "_ipp._tcp"));
+        set.add(makeService("A", "_http._tcp"));
+        set.add(makeService("A", "_ipp._tcp", 3));
+        set.add(makeService("A", "_ipp._tcp"));
+        set.add(heap);
+        set.share(heap);
+        set.sort();
+        check(set.size() == 6, "six services in the set");
+
+        const MDNSFlatService *found = set.find("A", "_ipp._tcp", "local", 3);
+        check(found && found->getInterfaceIndex() == 3, "find by interface index");
+        check(set.find("A", "_ipp._tcp", "local", 4) == 0, "find with unknown interface index");
+        check(set.find("C", "_ipp._tcp", "local", 2) == 0, "find unknown name");
+        check(set.find("A", "_http._tcp", "local", 2) != 0, "find in the first type");
+
+        std::pair<MDNSFlatServiceSet::const_iterator, MDNSFlatServiceSet::const_iterator> range = set.findByType("_ipp._tcp");
+        check(range.second - range.first == 5, "five services of the type");
+        bool sorted = true;
+        for (auto it = range.first; it != range.second; ++it)
+            sorted = sorted && it->getType() == "_ipp._tcp" && (it == range.first || !(it->getName() < (it - 1)->getName()));
+        check(sorted, "services of the type are sorted by name");
+        range = set.findByType("_ftp._tcp");
+        check(range.first == range.second, "no services of an unknown type");
+
+        int shared = 0;
+        for (auto it = set.begin(), iend = set.end(); it != iend; ++it)
+            shared += it->getName().data() == heap.getName().data();
+        check(shared == 1, "shared services keep their block");
+
+        survivor = *set.find("B", "_ipp._tcp", "local", 2);
+    }
+    check(survivor.isArenaAllocated() && survivor.getName() == "B" && survivor.getHost() == "host.local",
+          "copy outlives its set");
+    survivor = MDNSFlatService();
+    check(survivor.isNull(), "last copy released");
+
+    std::cout<<(failures ? "FAILED" : "OK")<<std::endl;
+    return failures ? 1 : 0;
+}
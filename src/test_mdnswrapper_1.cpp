@@ -6,10 +6,16 @@
  */
 
 #include "MDNSManager.hpp"
+#include "MDNSTypedService.hpp"
 #include <iostream>
 
 using namespace MDNS;
 
+MDNS_TXT_KEY(PathKey, "path", MDNSStringRef, "/");
+MDNS_TXT_KEY(FooKey, "FOO", MDNSStringRef, "");
+MDNS_SERVICE_TYPE(HttpService, "_http._tcp", MDNSTxtSchema<PathKey, FooKey>);
+MDNS_SERVICE_SUBTYPE(ArvidaSubtype, HttpService, "_arvida");
+
 class MyBrowser: public MDNSServiceBrowser
 {
 public:
@@ -32,6 +38,11 @@ public:
             }
             std::cerr << "  ]"<<std::endl;
         }
+        if (isServiceOfType<HttpService>(service))
+        {
+            MDNSTxtView<HttpService::TxtSchema> txt(service);
+            std::cerr << "  path: "<<txt.get<PathKey>()<<std::endl;
+        }
     }
 
     void onRemovedService(const std::string &name, const std::string &type, const std::string &domain, MDNSInterfaceIndex interfaceIndex) override
@@ -63,17 +74,20 @@ int main(int argc, char **argv)
     MyBrowser::Ptr arvidaBrowser = std::make_shared<MyBrowser>("ARVIDA");
     MyBrowser::Ptr allBrowser = std::make_shared<MyBrowser>("ALL");
 
-    mgr.registerServiceBrowser(httpBrowser, MDNS_IF_ANY, "_http._tcp", "");
-    mgr.registerServiceBrowser(arvidaBrowser, MDNS_IF_ANY, "_http._tcp", {"_arvida"}, "");
+    registerTypedServiceBrowser<HttpService>(mgr, httpBrowser, MDNS_IF_ANY, "");
+    registerTypedSubtypeBrowser<ArvidaSubtype>(mgr, arvidaBrowser, MDNS_IF_ANY, "");
     //mgr.registerServiceBrowser(MDNS_IF_ANY, "", "", allBrowser);
 
-    s1.setName("MyService").setPort(8080).setType("_http._tcp").addTxtRecord("path=/foobar");
+    setServiceType<HttpService>(s1).setName("MyService").setPort(8080);
+    addTxtValue<PathKey>(s1, "/foobar");
     mgr.registerService(s1);
 
     std::cout << "Running loop...";
     mgr.run();
 
-    s2.setName("ARVIDA Service").setPort(9090).setType("_http._tcp").addSubtype("_arvida").addTxtRecord("FOO=BOO");
+    setServiceType<HttpService>(s2).setName("ARVIDA Service").setPort(9090);
+    addServiceSubtype<ArvidaSubtype>(s2);
+    addTxtValue<FooKey>(s2, "BOO");
     mgr.registerService(s2);
 
     std::cin.get();
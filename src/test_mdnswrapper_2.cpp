@@ -0,0 +1,193 @@
+/*
+ * test_mdnswrapper_2.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include "MDNSManager.hpp"
+#include "MDNSSendScheduler.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace MDNS;
+
+static void printStats(const MDNSSendScheduler &scheduler)
+{
+    MDNSSendScheduler::Stats stats = scheduler.getStats();
+    std::cout<<"Batches: "<<stats.batches<<std::endl;
+    for (int i = 0; i < MDNS_SEND_NUM_PRIORITIES; ++i)
+    {
+        const MDNSSendScheduler::PriorityStats &ps = stats.priorities[i];
+        std::cout<<"  "<<toString(static_cast<MDNSSendPriority>(i))
+                 <<": enqueued "<<ps.enqueued<<", dispatched "<<ps.dispatched
+                 <<", cancelled "<<ps.cancelled<<", queued "<<ps.queued
+                 <<", records "<<ps.records
+                 <<", avg delay "<<ps.getAverageDelay().count()<<" us"
+                 <<", max delay "<<ps.maxDelay.count()<<" us"<<std::endl;
+    }
+}
+
+static int failures = 0;
+
+static void check(bool condition, const std::string &what)
+{
+    if (!condition)
+    {
+        std::cerr<<"FAILED: "<<what<<std::endl;
+        ++failures;
+    }
+}
+
+class NullBrowser : public MDNSServiceBrowser
+{
+public:
+    void onNewService(const MDNSService &) override { }
+    void onRemovedService(const std::string &, const std::string &, const std::string &, MDNSInterfaceIndex) override { }
+};
+
+static bool isRejected(MDNSManager &mgr, const MDNSSendScheduler::RateLimit &limit)
+{
+    try
+    {
+        MDNSSendScheduler invalid(mgr, limit);
+    }
+    catch (std::invalid_argument &)
+    {
+        return true;
+    }
+    return false;
+}
+
+/**
+ * With an empty bucket, a query, a registration and a goodbye enqueued in
+ * this order are dispatched in the order goodbye, probe, query.
+ */
+static void checkPriorityOrder(MDNSManager &mgr)
+{
+    // 3 records per operation refill in 150 ms
+    MDNSSendScheduler scheduler(mgr, MDNSSendScheduler::RateLimit(20.0, 3.0));
+    MDNSService first, second;
+    first.setName("Priority Service 1").setPort(10001).setType("_http._tcp");
+    second.setName("Priority Service 2").setPort(10002).setType("_http._tcp");
+
+    // Empties the bucket
+    scheduler.registerService(first);
+    scheduler.flush();
+
+    MDNSServiceBrowser::Ptr browser = std::make_shared<NullBrowser>();
+    scheduler.registerServiceBrowser(browser, MDNS_IF_ANY, "_http._tcp", std::string());
+    scheduler.registerService(second);
+    scheduler.unregisterService(first);
+
+    std::vector<MDNSSendPriority> order;
+    std::uint64_t seen[MDNS_SEND_NUM_PRIORITIES] = { 0, 0, 0 };
+    seen[MDNS_SEND_PROBE] = 1;
+    const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (order.size() < 3 && std::chrono::steady_clock::now() < deadline)
+    {
+        const MDNSSendScheduler::Stats stats = scheduler.getStats();
+        for (int i = 0; i < MDNS_SEND_NUM_PRIORITIES; ++i)
+        {
+            for (; seen[i] < stats.priorities[i].dispatched; ++seen[i])
+                order.push_back(static_cast<MDNSSendPriority>(i));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    check(order.size() == 3, "goodbye, probe and query dispatched");
+    check(order.size() == 3 && order[0] == MDNS_SEND_GOODBYE && order[1] == MDNS_SEND_PROBE && order[2] == MDNS_SEND_QUERY,
+          "goodbye before probe before query when the bucket is empty");
+
+    scheduler.unregisterService(second);
+    scheduler.flush();
+    mgr.unregisterServiceBrowser(browser);
+}
+
+/** Every enqueued operation was dispatched or cancelled */
+static void checkDrained(const MDNSSendScheduler &scheduler)
+{
+    MDNSSendScheduler::Stats stats = scheduler.getStats();
+    for (int i = 0; i < MDNS_SEND_NUM_PRIORITIES; ++i)
+    {
+        const MDNSSendScheduler::PriorityStats &ps = stats.priorities[i];
+        const std::string name = toString(static_cast<MDNSSendPriority>(i));
+        check(ps.queued == 0, name + " queue is empty");
+        check(ps.enqueued == ps.dispatched + ps.cancelled, name + " operations are dispatched or cancelled");
+    }
+    check(scheduler.getQueueSize() == 0, "scheduler is drained");
+}
+
+int main(int argc, char **argv)
+{
+    const int numServices = argc > 1 ? std::atoi(argv[1]) : 200;
+
+    MDNSManager mgr;
+
+    mgr.setErrorHandler([](const std::string &errorMsg)
+    {
+        std::cerr<<"ERROR "<<errorMsg<<std::endl;
+    });
+
+    check(isRejected(mgr, MDNSSendScheduler::RateLimit(0.0, 30.0)), "rate limit of 0 records per second is rejected");
+    check(isRejected(mgr, MDNSSendScheduler::RateLimit(100.0, 0.0)), "burst of 0 records is rejected");
+    check(isRejected(mgr, MDNSSendScheduler::RateLimit(100.0, -1.0)), "negative burst is rejected");
+    check(isRejected(mgr, MDNSSendScheduler::RateLimit(100.0, std::numeric_limits<double>::quiet_NaN())), "NaN burst is rejected");
+
+    MDNSSendScheduler scheduler(mgr, MDNSSendScheduler::RateLimit(100.0, 30.0));
+
+    scheduler.setErrorHandler([](const std::string &errorMsg)
+    {
+        std::cerr<<"SCHEDULER ERROR "<<errorMsg<<std::endl;
+    });
+
+    std::vector<MDNSService> services(numServices);
+    for (int i = 0; i < numServices; ++i)
+    {
+        std::ostringstream name;
+        name << "Scheduled Service " << i;
+        services[i].setName(name.str()).setPort(10000 + i).setType("_http._tcp").addTxtRecord("path=/foobar");
+    }
+
+    std::cout << "Running loop..."<<std::endl;
+    mgr.run();
+
+    std::cout<<"Checking priority order..."<<std::endl;
+    checkPriorityOrder(mgr);
+
+    for (auto it = services.begin(), iend = services.end(); it != iend; ++it)
+    {
+        scheduler.registerService(*it);
+    }
+
+    std::cout<<"Registering "<<numServices<<" services..."<<std::endl;
+    scheduler.flush();
+    printStats(scheduler);
+    checkDrained(scheduler);
+    check(scheduler.getStats().priorities[MDNS_SEND_PROBE].dispatched == static_cast<std::uint64_t>(numServices),
+          "all registrations dispatched");
+
+    std::cout<<"Unregister services..."<<std::endl;
+
+    for (auto it = services.begin(), iend = services.end(); it != iend; ++it)
+    {
+        scheduler.unregisterService(*it);
+    }
+    // Goodbyes are still pending, they must not refer to the services
+    services.clear();
+    scheduler.flush();
+    printStats(scheduler);
+    checkDrained(scheduler);
+    check(scheduler.getStats().priorities[MDNS_SEND_GOODBYE].dispatched == static_cast<std::uint64_t>(numServices),
+          "all goodbyes dispatched");
+
+    std::cout<<(failures ? "FAILED" : "OK")<<std::endl;
+    return failures ? 1 : 0;
+}
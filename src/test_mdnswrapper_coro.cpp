@@ -0,0 +1,69 @@
+/*
+ * test_mdnswrapper_coro.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include "MDNSManager.hpp"
+#include "MDNSCoroutines.hpp"
+#include <iostream>
+#include <thread>
+
+using namespace MDNS;
+
+static MDNSTask<void> discover(MDNSEventLoop &loop, MDNSCancellationToken token)
+{
+    MDNSService s1;
+    s1.setName("MyService").setPort(8080).setType("_http._tcp").addTxtRecord("path=/foobar");
+
+    bool announced = co_await registerServiceAsync(loop, s1, std::chrono::seconds(5), token);
+    std::cerr<<"Service "<<s1.getName()<<(announced ? " announced" : " not announced yet")<<std::endl;
+
+    // Browse, then resolve the first three matches
+    std::vector<MDNSService> services =
+        co_await resolveServices(loop, MDNS_IF_ANY, "_http._tcp", {}, 3, std::chrono::seconds(3), token);
+
+    for (auto it = services.begin(), iend = services.end(); it != iend; ++it)
+    {
+        std::cerr<<"Connect to "<<it->getName()<<" at "<<it->getHost()<<":"<<it->getPort()<<std::endl;
+    }
+
+    // Stream further events until cancelled or idle for 10 seconds
+    MDNSBrowseStream::Ptr stream = MDNSBrowseStream::create(loop, MDNS_IF_ANY, "_http._tcp", {}, "", token);
+    while (auto event = co_await stream->next(std::chrono::seconds(10)))
+    {
+        std::cerr<<(event->kind == MDNSBrowseEvent::NEW_SERVICE ? "New " : "Removed ")
+                 <<event->service.getName()<<std::endl;
+    }
+    stream->close();
+
+    loop.getManager().unregisterService(s1);
+}
+
+int main()
+{
+    MDNSManager mgr;
+
+    mgr.setErrorHandler([](const std::string &errorMsg)
+    {
+        std::cerr<<"ERROR "<<errorMsg<<std::endl;
+    });
+
+    std::cout << "Running loop..."<<std::endl;
+    mgr.run();
+
+    MDNSEventLoop loop(mgr);
+    MDNSCancellationSource cancel;
+    std::thread input([&cancel]()
+    {
+        std::cin.get();
+        cancel.cancel();
+    });
+
+    // Coroutines run on this thread, the input thread only requests cancellation
+    syncWait(loop, discover(loop, cancel.getToken()));
+
+    std::cout<<"Press enter to exit"<<std::endl;
+    input.join();
+    std::cout<<"Exiting"<<std::endl;
+}
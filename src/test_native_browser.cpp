@@ -0,0 +1,257 @@
+/*
+ * test_native_browser.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+// Record lifetimes of MDNSNativeBrowser: the test plays the responder on a
+// loopback socket, answers queries by hand and checks refresh queries,
+// per record expiry, SRV goodbyes and repeated resolve queries.
+
+#include "MDNSManager.hpp"
+#include "MDNSNativeBrowser.hpp"
+#include "MDNSNativeSocket.hpp"
+#include "MDNSPacket.hpp"
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace MDNS;
+
+namespace
+{
+
+typedef std::chrono::steady_clock Clock;
+
+const char * const TYPE = "_test._tcp.local";
+
+int failures = 0;
+
+void check(bool condition, const std::string &what)
+{
+    if (!condition)
+    {
+        std::cerr<<"FAILED: "<<what<<std::endl;
+        ++failures;
+    }
+}
+
+class RecordingBrowser : public MDNSServiceBrowser
+{
+public:
+
+    void onNewService(const MDNSService &service) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        events_.push_back("+" + service.getName());
+    }
+
+    void onRemovedService(const std::string &name, const std::string &, const std::string &, MDNSInterfaceIndex) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        events_.push_back("-" + name);
+    }
+
+    /** Wait until the event was reported, consumes it and all events before */
+    bool waitFor(const std::string &event, std::chrono::milliseconds timeout)
+    {
+        const Clock::time_point deadline = Clock::now() + timeout;
+        while (Clock::now() < deadline)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                for (std::size_t i = 0; i < events_.size(); ++i)
+                {
+                    if (events_[i] == event)
+                    {
+                        events_.erase(events_.begin(), events_.begin() + i + 1);
+                        return true;
+                    }
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return false;
+    }
+
+    std::vector<std::string> getEvents()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return events_;
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<std::string> events_;
+};
+
+class Responder
+{
+public:
+
+    bool open(std::string *error)
+    {
+        MDNSNativeSocket::Options options;
+        options.bindAddress = "127.0.0.1";
+        return socket_.open(options, error);
+    }
+
+    MDNSNativeSocket::Endpoint getEndpoint() const { return socket_.getLocalEndpoint(); }
+
+    void setBrowser(const MDNSNativeSocket::Endpoint &browser) { browser_ = browser; }
+
+    void send(const std::vector<MDNSRecord> &records)
+    {
+        MDNSMessage message;
+        message.flags = MDNS_FLAG_RESPONSE | MDNS_FLAG_AUTHORITATIVE;
+        message.answers = records;
+        const std::string data = encodeMessage(message);
+        socket_.sendTo(data.data(), data.size(), browser_);
+    }
+
+    /**
+     * Receive queries until one asks for name and type or the timeout
+     * expires, counts all received queries.
+     */
+    bool waitForQuestion(const std::string &name, std::uint16_t type, std::chrono::milliseconds timeout,
+                         unsigned int *queries = 0)
+    {
+        const Clock::time_point deadline = Clock::now() + timeout;
+        std::vector<std::uint8_t> packet;
+        MDNSMessage message;
+        for (Clock::time_point now = Clock::now(); now < deadline; now = Clock::now())
+        {
+            MDNSNativeSocket::Endpoint source;
+            if (!socket_.receive(packet, source, std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now)) ||
+                !decodeMessage(packet.data(), packet.size(), message) || message.isResponse())
+                continue;
+            if (queries)
+                ++*queries;
+            for (auto it = message.questions.begin(), iend = message.questions.end(); it != iend; ++it)
+            {
+                if (it->type == type && equalNames(it->name, name))
+                    return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    MDNSNativeSocket socket_;
+    MDNSNativeSocket::Endpoint browser_;
+};
+
+std::string instanceName(const std::string &name)
+{
+    return makeInstanceName(name, "_test._tcp", "local");
+}
+
+std::vector<MDNSRecord> makeInstance(const std::string &name, std::uint32_t ptrTtl, std::uint32_t srvTtl, std::uint32_t txtTtl)
+{
+    std::vector<MDNSRecord> records;
+    records.push_back(MDNSRecord::makePtr(TYPE, instanceName(name), ptrTtl));
+    records.push_back(MDNSRecord::makeSrv(instanceName(name), "host.local", 8080, srvTtl));
+    records.push_back(MDNSRecord::makeTxt(instanceName(name), std::vector<std::string>(1, "path=/"), txtTtl));
+    return records;
+}
+
+} // namespace
+
+int main()
+{
+    std::string error;
+    Responder responder;
+    if (!responder.open(&error))
+    {
+        std::cerr<<"Could not open responder socket: "<<error<<std::endl;
+        return 1;
+    }
+
+    std::shared_ptr<RecordingBrowser> events = std::make_shared<RecordingBrowser>();
+    MDNSNativeBrowser::Options options;
+    options.destination = responder.getEndpoint();
+    options.minInitialDelay = std::chrono::milliseconds(0);
+    options.maxInitialDelay = std::chrono::milliseconds(0);
+    // Only the first periodic query falls into the test
+    options.firstInterval = std::chrono::milliseconds(60000);
+    MDNSNativeBrowser browser(events, "_test._tcp", "local", options);
+
+    MDNSNativeSocket::Options socketOptions;
+    socketOptions.bindAddress = "127.0.0.1";
+    if (!browser.start(socketOptions, &error))
+    {
+        std::cerr<<"Could not start browser: "<<error<<std::endl;
+        return 1;
+    }
+    responder.setBrowser(browser.getLocalEndpoint());
+    check(responder.waitForQuestion(TYPE, MDNS_TYPE_PTR, std::chrono::milliseconds(1000)), "initial PTR query");
+
+    // A: SRV record with short TTL, B: all records long-lived
+    std::cout<<"Refresh and expiry of a SRV record..."<<std::endl;
+    std::vector<MDNSRecord> a = makeInstance("A", 100, 2, 100);
+    std::vector<MDNSRecord> b = makeInstance("B", 100, 100, 100);
+    std::vector<MDNSRecord> records(a);
+    records.insert(records.end(), b.begin(), b.end());
+    const Clock::time_point received = Clock::now();
+    responder.send(records);
+    check(events->waitFor("+A", std::chrono::milliseconds(1000)), "A added");
+    check(events->waitFor("+B", std::chrono::milliseconds(1000)), "B added");
+
+    // Refresh questions at 80, 85, 90 and 95% (plus up to 2%) of 2 s, left
+    // unanswered. After the expiry the PTR record of A is still valid and
+    // the SRV record is asked for again.
+    unsigned int refreshes = 0;
+    bool resolved = false;
+    Clock::time_point firstRefresh;
+    while (!resolved && responder.waitForQuestion(instanceName("A"), MDNS_TYPE_SRV, std::chrono::milliseconds(2500)))
+    {
+        if (Clock::now() - received >= std::chrono::milliseconds(1980))
+            resolved = true;
+        else if (refreshes++ == 0)
+            firstRefresh = Clock::now();
+    }
+    check(refreshes == 4, "four refresh queries for the SRV record, got " + std::to_string(refreshes));
+    check(firstRefresh - received >= std::chrono::milliseconds(1590), "first refresh at 80% of the TTL");
+    check(resolved, "SRV record of A asked for after expiry");
+    check(events->waitFor("-A", std::chrono::milliseconds(1000)), "A removed after its SRV record expired");
+    responder.send(std::vector<MDNSRecord>(1, MDNSRecord::makeSrv(instanceName("A"), "host.local", 8080, 100)));
+    check(events->waitFor("+A", std::chrono::milliseconds(1000)), "A added again after resolving");
+
+    std::cout<<"SRV goodbye..."<<std::endl;
+    responder.send(std::vector<MDNSRecord>(1, MDNSRecord::makeSrv(instanceName("B"), "host.local", 8080, 0)));
+    check(events->waitFor("-B", std::chrono::milliseconds(1000)), "B removed by SRV goodbye");
+    check(responder.waitForQuestion(instanceName("B"), MDNS_TYPE_SRV, std::chrono::milliseconds(1000)),
+          "SRV record of B asked for after goodbye");
+    responder.send(std::vector<MDNSRecord>(1, MDNSRecord::makeSrv(instanceName("B"), "host.local", 8081, 100)));
+    check(events->waitFor("+B", std::chrono::milliseconds(1000)), "B added again after resolving");
+
+    std::cout<<"Repeated resolve queries..."<<std::endl;
+    responder.send(std::vector<MDNSRecord>(1, MDNSRecord::makePtr(TYPE, instanceName("C"), 100)));
+    unsigned int queries = 0;
+    check(responder.waitForQuestion(instanceName("C"), MDNS_TYPE_TXT, std::chrono::milliseconds(1000)),
+          "TXT record of C asked for");
+    const Clock::time_point firstResolve = Clock::now();
+    check(responder.waitForQuestion(instanceName("C"), MDNS_TYPE_TXT, std::chrono::milliseconds(2000), &queries),
+          "TXT record of C asked for again");
+    check(Clock::now() - firstResolve >= std::chrono::milliseconds(900), "resolve queries are repeated after a delay");
+    std::vector<MDNSRecord> c = makeInstance("C", 100, 100, 100);
+    responder.send(std::vector<MDNSRecord>(c.begin() + 1, c.end()));
+    check(events->waitFor("+C", std::chrono::milliseconds(1000)), "C added after resolving");
+
+    std::cout<<"PTR goodbye..."<<std::endl;
+    responder.send(std::vector<MDNSRecord>(1, MDNSRecord::makePtr(TYPE, instanceName("C"), 0)));
+    check(events->waitFor("-C", std::chrono::milliseconds(1000)), "C removed by PTR goodbye");
+
+    browser.stop();
+    const std::vector<std::string> remaining = events->getEvents();
+    check(remaining.empty(), "no further events");
+    const MDNSNativeBrowser::Stats stats = browser.getStats();
+    check(stats.servicesAdded == 5 && stats.servicesRemoved == 3, "added and removed services are counted");
+
+    std::cout<<(failures ? "FAILED" : "OK")<<std::endl;
+    return failures ? 1 : 0;
+}
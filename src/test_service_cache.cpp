@@ -0,0 +1,170 @@
+/*
+ * test_service_cache.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include "MDNSManager.hpp"
+#include "MDNSServiceCache.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace MDNS;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string &what)
+{
+    if (!condition)
+    {
+        std::cerr<<"FAILED: "<<what<<std::endl;
+        ++failures;
+    }
+}
+
+/** All services have the same footprint, names are long enough to be heap allocated */
+static MDNSService makeService(const std::string &name)
+{
+    MDNSService service;
+    service.setName("Cached Service With A Long Name " + name)
+        .setType("_http._tcp")
+        .setDomain("local")
+        .setPort(8080)
+        .addTxtRecord("path=/some/resource/path");
+    return service;
+}
+
+static bool isCached(const MDNSCachingBrowser::Ptr &cache, const std::string &name)
+{
+    const MDNSService service = makeService(name);
+    const std::vector<MDNSService> services = cache->getServices();
+    for (auto it = services.begin(), iend = services.end(); it != iend; ++it)
+    {
+        if (it->getName() == service.getName())
+            return true;
+    }
+    return false;
+}
+
+/** Cached names, most recently used first */
+static std::string getOrder(const MDNSCachingBrowser::Ptr &cache)
+{
+    const std::string prefix = "Cached Service With A Long Name ";
+    std::string order;
+    const std::vector<MDNSService> services = cache->getServices();
+    for (auto it = services.begin(), iend = services.end(); it != iend; ++it)
+        order += (order.empty() ? "" : " ") + it->getName().substr(prefix.size());
+    return order;
+}
+
+/** Looks up the service, returns true when found */
+static bool lookup(const MDNSCachingBrowser::Ptr &cache, const std::string &name)
+{
+    const MDNSService key = makeService(name);
+    MDNSService service;
+    return cache->lookup(key.getName(), key.getType(), key.getDomain(), key.getInterfaceIndex(), service);
+}
+
+int main()
+{
+    const std::size_t entryBytes = MDNSCachingBrowser::getServiceBytes(makeService("a0"));
+
+    // Measure the accounted size of one entry including key and containers
+    std::size_t bytes = 0;
+    {
+        MDNSCachingBrowser::Ptr probe = MDNSCachingBrowser::create(0);
+        probe->onNewService(makeService("a0"));
+        bytes = probe->getStats().bytes;
+    }
+    check(bytes > entryBytes, "entry accounts key and containers");
+
+    // Cache a holds 3 entries, both caches together 5 entries
+    MDNSCacheBudget::Ptr budget = std::make_shared<MDNSCacheBudget>(5 * bytes);
+    MDNSCachingBrowser::Ptr a = MDNSCachingBrowser::create(3 * bytes, budget);
+    MDNSCachingBrowser::Ptr b = MDNSCachingBrowser::create(0, budget);
+
+    std::vector<std::string> resolved;
+    MDNSCachingBrowser::ResolveHandler handler = [&resolved](const std::string &name, const std::string &,
+                                                            const std::string &, MDNSInterfaceIndex)
+    {
+        resolved.push_back(name.substr(std::string("Cached Service With A Long Name ").size()));
+    };
+    a->setResolveHandler(handler);
+    b->setResolveHandler(handler);
+
+    // Per browser limit
+    for (int i = 0; i < 5; ++i)
+        a->onNewService(makeService("a" + std::to_string(i)));
+    check(getOrder(a) == "a4 a3 a2", "per browser limit evicts least recently used, got " + getOrder(a));
+    check(a->getStats().evictions == 2, "two evictions by the per browser limit");
+    check(budget->getEvictions() == 0, "no evictions by the budget");
+    check(budget->getUsedBytes() == 3 * bytes, "budget accounts cached entries");
+
+    // Lookups and LRU updates change the recency order
+    check(lookup(a, "a2"), "lookup of cached service");
+    check(getOrder(a) == "a2 a4 a3", "lookup moves entry to the front, got " + getOrder(a));
+    a->onNewService(makeService("a4"));
+    check(getOrder(a) == "a4 a2 a3", "update moves entry to the front, got " + getOrder(a));
+
+    // Global budget evicts from the largest cache, a is attached first and wins ties
+    b->onNewService(makeService("b0"));
+    b->onNewService(makeService("b1"));
+    check(budget->getEvictions() == 0, "budget not exceeded yet");
+    b->onNewService(makeService("b2"));
+    check(getOrder(a) == "a4 a2", "budget evicts from cache a on a tie, got " + getOrder(a));
+    b->onNewService(makeService("b3"));
+    check(getOrder(b) == "b3 b2 b1", "budget evicts from the larger cache b, got " + getOrder(b));
+    check(budget->getEvictions() == 2, "two evictions by the budget");
+    check(budget->getUsedBytes() == 5 * bytes, "budget is full");
+    check(a->getStats().bytes + b->getStats().bytes == budget->getUsedBytes(), "budget equals the sum of the caches");
+
+    // Lookups of evicted services request a re-resolve once
+    check(resolved.empty(), "nothing re-resolved yet");
+    check(!lookup(a, "a0"), "evicted service a0 is a miss");
+    check(!lookup(a, "a3"), "evicted service a3 is a miss");
+    check(!lookup(b, "b0"), "evicted service b0 is a miss");
+    check(!lookup(a, "a0"), "evicted service a0 is still a miss");
+    check(!lookup(b, "x0"), "unknown service is a miss");
+    check(resolved == std::vector<std::string>({ "a0", "a3", "b0" }), "evicted services are re-resolved once");
+    check(a->getStats().reresolves == 2 && b->getStats().reresolves == 1, "re-resolves are counted");
+    check(a->getStats().misses == 3 && b->getStats().misses == 2, "misses are counted");
+
+    // The re-resolved service pushes out the least recently used entry of cache a
+    a->onNewService(makeService("a3"));
+    check(getOrder(a) == "a3 a4", "re-resolved service is cached again, got " + getOrder(a));
+    check(isCached(b, "b1") && !isCached(a, "a2"), "budget evicts a2 from a on a tie");
+    check(budget->getUsedBytes() == 5 * bytes, "budget is still full");
+
+    // Removed services are neither cached nor re-resolved
+    const MDNSService b1 = makeService("b1");
+    b->onRemovedService(b1.getName(), b1.getType(), b1.getDomain(), b1.getInterfaceIndex());
+    check(getOrder(b) == "b3 b2", "removed service is dropped, got " + getOrder(b));
+    check(!lookup(b, "b1"), "removed service is a miss");
+    check(resolved.size() == 3, "removed service is not re-resolved");
+
+    // The history of evicted keys is bounded
+    b->setEvictedHistorySize(1);
+    check(!lookup(a, "a2"), "evicted service a2 is a miss");
+    check(resolved.size() == 4 && resolved.back() == "a2", "a2 is re-resolved");
+    a->setEvictedHistorySize(0);
+    a->setLimit(bytes);
+    check(getOrder(a) == "a3", "lowered limit evicts, got " + getOrder(a));
+    check(!lookup(a, "a4"), "evicted service a4 is a miss");
+    check(resolved.size() == 4, "no history, a4 is not re-resolved");
+
+    // Least recently queried policy: updates do not change the order
+    MDNSCachingBrowser::Ptr q = MDNSCachingBrowser::create(2 * bytes, MDNSCacheBudget::Ptr(),
+                                                           MDNSServiceBrowser::Ptr(), MDNS_EVICT_LEAST_RECENTLY_QUERIED);
+    q->onNewService(makeService("q0"));
+    q->onNewService(makeService("q1"));
+    q->onNewService(makeService("q0"));
+    q->onNewService(makeService("q2"));
+    check(getOrder(q) == "q2 q1", "update of q0 does not protect it, got " + getOrder(q));
+
+    a.reset();
+    check(budget->getUsedBytes() == b->getStats().bytes, "destroyed cache releases its budget");
+
+    std::cout<<(failures ? "FAILED" : "OK")<<std::endl;
+    return failures ? 1 : 0;
+}
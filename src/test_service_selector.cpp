@@ -0,0 +1,149 @@
+/*
+ * test_service_selector.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include "MDNSManager.hpp"
+#include "MDNSServiceSelector.hpp"
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace MDNS;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string &what)
+{
+    if (!condition)
+    {
+        std::cerr<<"FAILED: "<<what<<std::endl;
+        ++failures;
+    }
+}
+
+static MDNSService makeService(const std::string &name, const std::string &weight,
+                               const std::vector<std::string> &subtypes = std::vector<std::string>(),
+                               const std::string &priority = std::string())
+{
+    MDNSService service;
+    service.setName(name).setType("_http._tcp").setDomain("local").setPort(8080).setSubtypes(subtypes);
+    if (!weight.empty())
+        service.addTxtRecord("weight=" + weight);
+    if (!priority.empty())
+        service.addTxtRecord("Priority=" + priority);
+    return service;
+}
+
+/** Fraction of picks per instance name */
+static std::map<std::string, double> sample(MDNSServiceSelector &selector, const std::string &subtype, int picks)
+{
+    std::map<std::string, int> counts;
+    MDNSEpochDomain::ReadGuard guard(selector.getDomain());
+    for (int i = 0; i < picks; ++i)
+    {
+        const MDNSService *service = selector.pick(guard, "_http._tcp", subtype);
+        ++counts[service ? service->getName() : std::string()];
+    }
+    std::map<std::string, double> fractions;
+    for (auto it = counts.begin(), iend = counts.end(); it != iend; ++it)
+        fractions[it->first] = static_cast<double>(it->second) / picks;
+    return fractions;
+}
+
+static bool near(const std::map<std::string, double> &fractions, const std::string &name, double expected)
+{
+    auto it = fractions.find(name);
+    const double actual = it == fractions.end() ? 0.0 : it->second;
+    return std::fabs(actual - expected) < 0.01;
+}
+
+int main()
+{
+    const int picks = 200000;
+    const std::vector<std::string> arvida(1, "_arvida");
+
+    MDNSServiceSelector::Options options;
+    options.priorityKey = "priority";
+    MDNSServiceSelector selector(options);
+
+    check(selector.getInstanceCount("_http._tcp") == 0, "no instances initially");
+    MDNSService none;
+    check(!selector.pick("_http._tcp", none), "nothing to pick initially");
+
+    // Distribution proportional to the weights
+    selector.onNewService(makeService("A", "1"));
+    selector.onNewService(makeService("B", "2", arvida));
+    selector.onNewService(makeService("C", "7", arvida));
+    selector.flush();
+    check(selector.getInstanceCount("_http._tcp") == 3, "three selectable instances");
+    std::map<std::string, double> fractions = sample(selector, "", picks);
+    check(near(fractions, "A", 0.1) && near(fractions, "B", 0.2) && near(fractions, "C", 0.7),
+          "picks are proportional to the weights");
+
+    // Subtype tables contain the instances announcing the subtype only
+    check(selector.getInstanceCount("_http._tcp", "_arvida") == 2, "two instances with the subtype");
+    fractions = sample(selector, "_arvida", picks);
+    check(near(fractions, "B", 2.0 / 9) && near(fractions, "C", 7.0 / 9) && !fractions.count("A"),
+          "subtype picks are proportional to the weights");
+
+    // Weight 0 instances are excluded while others are available
+    selector.onNewService(makeService("Z", "0", arvida));
+    selector.flush();
+    check(selector.getInstanceCount("_http._tcp") == 3, "weight 0 instance is not counted");
+    check(selector.getInstanceCount("_http._tcp", "_arvida") == 2, "weight 0 instance is not counted in the subtype");
+    fractions = sample(selector, "", picks);
+    check(!fractions.count("Z"), "weight 0 instance is never picked");
+
+    // Case-insensitive keys, invalid weights fall back to the default weight 1
+    selector.onNewService(makeService("A", "").addTxtRecord("WEIGHT=3"));
+    selector.onNewService(makeService("C", "oops", arvida));
+    selector.flush();
+    fractions = sample(selector, "", picks);
+    check(near(fractions, "A", 0.5) && near(fractions, "B", 2.0 / 6) && near(fractions, "C", 1.0 / 6),
+          "updated weights are used");
+
+    // Updates that drop the subtype rebuild the subtype table
+    selector.onNewService(makeService("B", "2"));
+    selector.flush();
+    check(selector.getInstanceCount("_http._tcp", "_arvida") == 1, "instance without the subtype is removed from its table");
+    fractions = sample(selector, "_arvida", picks);
+    check(near(fractions, "C", 1.0), "only remaining subtype instance is picked");
+
+    // Only weight 0 instances are left: all of them are picked
+    selector.onRemovedService("A", "_http._tcp", "local", MDNS_IF_ANY);
+    selector.onRemovedService("B", "_http._tcp", "local", MDNS_IF_ANY);
+    selector.onRemovedService("C", "_http._tcp", "local", MDNS_IF_ANY);
+    selector.onNewService(makeService("Y", "0"));
+    selector.flush();
+    check(selector.getInstanceCount("_http._tcp") == 2, "all weight 0 instances are selectable");
+    check(selector.getInstanceCount("_http._tcp", "_arvida") == 1, "weight 0 subtype instance is selectable");
+    fractions = sample(selector, "", picks);
+    check(near(fractions, "Y", 0.5) && near(fractions, "Z", 0.5), "weight 0 instances are picked uniformly");
+
+    // Lowest priority value wins regardless of the weights
+    selector.onNewService(makeService("P", "1", arvida, "1"));
+    selector.onNewService(makeService("Q", "100", arvida, "2"));
+    selector.onNewService(makeService("Y", "0", std::vector<std::string>(), "3"));
+    selector.onNewService(makeService("Z", "0", arvida, "3"));
+    selector.flush();
+    check(selector.getInstanceCount("_http._tcp") == 1, "only the lowest priority is selectable");
+    fractions = sample(selector, "_arvida", picks);
+    check(near(fractions, "P", 1.0), "lowest priority instance is picked");
+
+    // Removing the last instances drops all tables of the type
+    selector.onRemovedService("P", "_http._tcp", "local", MDNS_IF_ANY);
+    selector.onRemovedService("Q", "_http._tcp", "local", MDNS_IF_ANY);
+    selector.onRemovedService("Y", "_http._tcp", "local", MDNS_IF_ANY);
+    selector.onRemovedService("Z", "_http._tcp", "local", MDNS_IF_ANY);
+    selector.flush();
+    check(selector.getInstanceCount("_http._tcp") == 0, "no instances left");
+    check(selector.getInstanceCount("_http._tcp", "_arvida") == 0, "no subtype instances left");
+    check(!selector.pick("_http._tcp", "_arvida", none), "nothing to pick from the subtype");
+
+    std::cout<<(failures ? "FAILED" : "OK")<<std::endl;
+    return failures ? 1 : 0;
+}
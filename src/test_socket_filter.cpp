@@ -0,0 +1,219 @@
+/*
+ * test_socket_filter.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include "MDNSNativeSocket.hpp"
+#include "MDNSPacket.hpp"
+#include "MDNSSocketFilter.hpp"
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/socket.h>
+#endif
+
+using namespace MDNS;
+
+struct TestPacket
+{
+    std::string description;
+    std::string data;
+    bool expectAccept;
+};
+
+static MDNSMessage makeQuery(const std::string &name, std::uint16_t type = MDNS_TYPE_PTR)
+{
+    MDNSMessage message;
+    message.questions.push_back(MDNSQuestion(name, type));
+    return message;
+}
+
+static MDNSMessage makeResponse(const MDNSRecord &record)
+{
+    MDNSMessage message;
+    message.flags = MDNS_FLAG_RESPONSE | MDNS_FLAG_AUTHORITATIVE;
+    message.answers.push_back(record);
+    return message;
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    MDNSSocketFilter filter;
+    filter.addBrowseType("_http._tcp")
+        .addBrowseSubtype("_arvida", "_http._tcp")
+        .addPublishedType("_printer._tcp")
+        .addOwnedInstance("My Printer", "_printer._tcp")
+        .addOwnedHost("myhost.local")
+        .addBrowsedHost("foo.local");
+
+    std::vector<TestPacket> packets;
+    auto add = [&packets](const std::string &description, MDNSMessage message, bool expectAccept)
+    {
+        // Message id identifies the packet on the receiving side
+        message.id = static_cast<std::uint16_t>(packets.size() + 1);
+        TestPacket packet = { description, encodeMessage(message), expectAccept };
+        packets.push_back(packet);
+    };
+
+    add("query published type", makeQuery("_printer._tcp.local"), true);
+    add("query published type, other case", makeQuery("_PRINTER._Tcp.LOCAL"), true);
+    add("query other type", makeQuery("_ipp._tcp.local"), false);
+    add("query owned instance", makeQuery("My Printer._printer._tcp.local", MDNS_TYPE_SRV), true);
+    add("query other instance", makeQuery("Other Printer._printer._tcp.local", MDNS_TYPE_SRV), false);
+    add("query owned host", makeQuery("myhost.local", MDNS_TYPE_A), true);
+    add("query without questions", MDNSMessage(), false);
+    add("response browsed type", makeResponse(MDNSRecord::makePtr("_http._tcp.local", "Foo._http._tcp.local", 4500)), true);
+    add("response browsed subtype", makeResponse(MDNSRecord::makePtr("_arvida._sub._http._tcp.local", "Foo._http._tcp.local", 4500)), true);
+    add("response other subtype", makeResponse(MDNSRecord::makePtr("_other._sub._http._tcp.local", "Foo._http._tcp.local", 4500)), false);
+    add("response instance of browsed type", makeResponse(MDNSRecord::makeSrv("Foo._http._tcp.local", "foo.local", 80, 120)), true);
+    add("response instance of published type", makeResponse(MDNSRecord::makeTxt("Rival._printer._tcp.local", std::vector<std::string>(1, "a=b"), 4500)), true);
+    add("response long instance label", makeResponse(MDNSRecord::makeSrv(std::string(63, 'x') + "._http._tcp.local", "foo.local", 80, 120)), true);
+    add("response instance of other type", makeResponse(MDNSRecord::makeSrv("Foo._ssh._tcp.local", "foo.local", 22, 120)), false);
+    add("response instance with suffix", makeResponse(MDNSRecord::makeSrv("Foo._http._tcp.localx", "foo.local", 80, 120)), false);
+    add("response other type", makeResponse(MDNSRecord::makePtr("_ssh._tcp.local", "Foo._ssh._tcp.local", 4500)), false);
+    add("response other host", makeResponse(MDNSRecord::makeA("otherhost.local", 0x0100007f, 120)), false);
+    add("response owned host (conflict)", makeResponse(MDNSRecord::makeA("myhost.local", 0x0100007f, 120)), true);
+    add("response browsed host (SRV target)", makeResponse(MDNSRecord::makeA("foo.local", 0x0100007f, 120)), true);
+
+    // Interesting names after the first question or answer
+    MDNSMessage secondQuestion = makeQuery("_ipp._tcp.local");
+    secondQuestion.questions.push_back(MDNSQuestion("_printer._tcp.local", MDNS_TYPE_PTR));
+    add("query published type as second question", secondQuestion, true);
+
+    MDNSMessage probe = makeQuery("Other Printer._printer._tcp.local", MDNS_TYPE_ANY);
+    probe.questions.push_back(MDNSQuestion("My Printer._printer._tcp.local", MDNS_TYPE_ANY));
+    probe.authorities.push_back(MDNSRecord::makeSrv("My Printer._printer._tcp.local", "otherhost.local", 631, 120));
+    add("probe for owned instance as second question", probe, true);
+
+    MDNSMessage secondAnswer = makeResponse(MDNSRecord::makeA("otherhost.local", 0x0100007f, 120));
+    secondAnswer.answers.push_back(MDNSRecord::makePtr("_http._tcp.local", "Foo._http._tcp.local", 4500));
+    add("response browsed type as second answer", secondAnswer, true);
+
+    MDNSMessage withAddress = makeResponse(MDNSRecord::makeSrv("Foo._ssh._tcp.local", "foo.local", 22, 120));
+    withAddress.additionals.push_back(MDNSRecord::makeA("otherhost.local", 0x0100007f, 120));
+    add("response other instance with additional record", withAddress, false);
+
+    MDNSMessage withQuestion = makeResponse(MDNSRecord::makeA("otherhost.local", 0x0100007f, 120));
+    withQuestion.questions.push_back(MDNSQuestion("otherhost.local", MDNS_TYPE_A));
+    add("response with questions", withQuestion, true);
+
+    MDNSMessage truncated = makeQuery("_ipp._tcp.local");
+    truncated.flags |= MDNS_FLAG_TRUNCATED;
+    add("truncated query", truncated, true);
+
+    TestPacket runt = { "runt packet", std::string("\x00\x01\x00\x00\x00", 5), false };
+    packets.push_back(runt);
+
+    int failures = 0;
+
+    // User space interpreter on bare DNS messages
+    const std::vector<MDNSBpfInstruction> bareProgram = filter.compile(0);
+    std::cout<<"Filter program: "<<bareProgram.size()<<" instructions"<<std::endl;
+    std::size_t expectedAccepted = 0, expectedDropped = 0;
+    for (auto it = packets.begin(), iend = packets.end(); it != iend; ++it)
+    {
+        const bool accepted = MDNSSocketFilter::run(bareProgram, it->data.data(), it->data.size()) != 0;
+        if (accepted != it->expectAccept)
+        {
+            std::cerr<<"FAIL (user space) "<<it->description<<": "<<(accepted ? "accepted" : "dropped")<<std::endl;
+            ++failures;
+        }
+        if (it->expectAccept)
+            ++expectedAccepted;
+        else
+            ++expectedDropped;
+    }
+
+    // Kernel filter on a loopback socket
+    std::string error;
+    MDNSNativeSocket receiver, sender;
+    MDNSNativeSocket::Options options;
+    options.bindAddress = "127.0.0.1";
+    if (!receiver.open(options, &error) || !sender.open(options, &error))
+    {
+        std::cerr<<"ERROR "<<error<<std::endl;
+        return 1;
+    }
+    if (!receiver.setFilter(filter, &error))
+    {
+        std::cerr<<"ERROR "<<error<<std::endl;
+        return 1;
+    }
+
+    const MDNSNativeSocket::Endpoint destination = receiver.getLocalEndpoint();
+    std::cout<<"Sending "<<packets.size()<<" packets to "<<destination.toString()<<std::endl;
+    for (auto it = packets.begin(), iend = packets.end(); it != iend; ++it)
+    {
+        if (!sender.sendTo(it->data.data(), it->data.size(), destination, &error))
+        {
+            std::cerr<<"ERROR "<<error<<std::endl;
+            return 1;
+        }
+    }
+    // Accepted packet sent last, carries the final drop count
+    add("marker", makeResponse(MDNSRecord::makePtr("_http._tcp.local", "Marker._http._tcp.local", 4500)), true);
+    const std::uint16_t markerId = static_cast<std::uint16_t>(packets.size());
+    sender.sendTo(packets.back().data.data(), packets.back().data.size(), destination);
+
+    std::set<std::uint16_t> receivedIds;
+    std::vector<std::uint8_t> packet;
+    MDNSNativeSocket::Endpoint source;
+    while (receiver.receive(packet, source, std::chrono::milliseconds(1000), &error))
+    {
+        const std::uint16_t id = packet.size() >= 2 ? static_cast<std::uint16_t>((packet[0] << 8) | packet[1]) : 0;
+        receivedIds.insert(id);
+        if (id == markerId)
+            break;
+    }
+
+    for (std::size_t i = 0; i + 1 < packets.size(); ++i)
+    {
+        const TestPacket &p = packets[i];
+        // The runt packet has no id of its own
+        if (p.data.size() < 12)
+            continue;
+        const bool accepted = receivedIds.count(static_cast<std::uint16_t>(i + 1)) != 0;
+        if (accepted != p.expectAccept)
+        {
+            std::cerr<<"FAIL (kernel) "<<p.description<<": "<<(accepted ? "accepted" : "dropped")<<std::endl;
+            ++failures;
+        }
+    }
+
+    const MDNSNativeSocket::Stats stats = receiver.getStats();
+    std::cout<<"Accepted "<<stats.accepted<<" (expected "<<expectedAccepted + 1<<"), dropped "
+             <<stats.dropped<<" (expected "<<expectedDropped<<")"<<std::endl;
+    if (stats.accepted != expectedAccepted + 1)
+    {
+        std::cerr<<"FAIL accepted count"<<std::endl;
+        ++failures;
+    }
+#ifdef SO_RXQ_OVFL
+    if (stats.dropped != expectedDropped)
+    {
+        std::cerr<<"FAIL dropped count"<<std::endl;
+        ++failures;
+    }
+#endif
+#if defined(__linux__) && defined(SO_MEMINFO)
+    // Drops are visible without receiving another packet
+    const MDNSMessage late = makeQuery("_ipp._tcp.local");
+    const std::string lateData = encodeMessage(late);
+    sender.sendTo(lateData.data(), lateData.size(), destination);
+    if (receiver.getStats().dropped != expectedDropped + 1)
+    {
+        std::cerr<<"FAIL dropped count without later packet"<<std::endl;
+        ++failures;
+    }
+#endif
+
+    std::cout<<(failures ? "FAILED" : "PASSED")<<std::endl;
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,159 @@
+/*
+ * test_typed_service.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include "MDNSManager.hpp"
+#include "MDNSPacket.hpp"
+#include "MDNSTypedService.hpp"
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace MDNS;
+
+MDNS_TXT_KEY(PathKey, "path", MDNSStringRef, "/");
+MDNS_TXT_KEY(WeightKey, "weight", unsigned int, 1);
+MDNS_TXT_KEY(VersionKey, "txtvers", int, 0);
+MDNS_TXT_KEY(SecureKey, "secure", bool, false);
+MDNS_TXT_KEY(NameKey, "Name", std::string, "");
+MDNS_SERVICE_TYPE(HttpService, "_http._tcp", MDNSTxtSchema<PathKey, WeightKey, VersionKey, SecureKey, NameKey>);
+MDNS_SERVICE_SUBTYPE(ArvidaSubtype, HttpService, "_arvida");
+
+typedef HttpService::TxtSchema Schema;
+
+// Computed at compile time
+static constexpr HttpService::WireNameT httpWireName = HttpService::wireName();
+static_assert(httpWireName.size() == 18, "wire name of _http._tcp.local has 18 bytes");
+static_assert(httpWireName.data()[0] == 5 && httpWireName.data()[6] == 4 && httpWireName.data()[11] == 5,
+              "label lengths replace the dots");
+static_assert(httpWireName.data()[17] == '\0', "wire name ends with the root label");
+
+static int failures = 0;
+
+static void check(bool condition, const std::string &what)
+{
+    if (!condition)
+    {
+        std::cerr<<"FAILED: "<<what<<std::endl;
+        ++failures;
+    }
+}
+
+template <class T>
+static bool parses(const std::string &text, T expected)
+{
+    T value = T();
+    return MDNSTxtValueTraits<T>::parse(MDNSStringRef(text), value) && value == expected;
+}
+
+template <class T>
+static bool isRejected(const std::string &text)
+{
+    T value = T(42);
+    return !MDNSTxtValueTraits<T>::parse(MDNSStringRef(text), value) && value == T(42);
+}
+
+static void checkWireNames()
+{
+    check(HttpService::wireName().str() == toWireName("_http._tcp.local"), "service type wire name");
+    check(ArvidaSubtype::wireName().str() == toWireName("_arvida._sub._http._tcp.local"), "subtype wire name");
+    check(ArvidaSubtype::wireName().ref() == MDNSStringRef(toWireName("_arvida._sub._http._tcp.local")),
+          "subtype wire name reference");
+}
+
+static void checkPerfectHash()
+{
+    const char *keys[] = { "path", "weight", "txtvers", "secure", "Name" };
+    std::vector<bool> usedSlots(Schema::tableSize, false);
+    for (int i = 0; i < static_cast<int>(Schema::size); ++i)
+    {
+        const std::uint32_t slot = fnv1aIgnoreCase(MDNSStringRef(keys[i])) % Schema::tableSize;
+        check(!usedSlots[slot], std::string("slot of ") + keys[i] + " is not shared");
+        usedSlots[slot] = true;
+        check(Schema::lookup(MDNSStringRef(keys[i])) == i, std::string("lookup of ") + keys[i]);
+        check(std::string(Schema::keyAt(i)) == keys[i], std::string("key at index of ") + keys[i]);
+    }
+
+    // Unknown keys that hash into the slot of a known key must still be rejected
+    int collisions = 0;
+    for (int i = 0; i < 10000 && collisions < 20; ++i)
+    {
+        std::ostringstream key;
+        key << "key" << i;
+        const std::uint32_t slot = fnv1aIgnoreCase(MDNSStringRef(key.str())) % Schema::tableSize;
+        if (!usedSlots[slot])
+            continue;
+        ++collisions;
+        check(Schema::lookup(MDNSStringRef(key.str())) == -1, "colliding unknown key " + key.str() + " is rejected");
+    }
+    check(collisions > 0, "colliding unknown keys found");
+    check(Schema::lookup(MDNSStringRef("")) == -1, "empty key is rejected");
+    check(Schema::lookup(MDNSStringRef("pat")) == -1, "prefix of a key is rejected");
+}
+
+static void checkIntegerParsing()
+{
+    check(parses<std::uint8_t>("255", 255), "largest uint8_t");
+    check(isRejected<std::uint8_t>("256"), "uint8_t overflow");
+    check(isRejected<std::uint8_t>("1000"), "uint8_t overflow by a digit");
+    check(parses<std::int8_t>("127", 127), "largest int8_t");
+    check(parses<std::int8_t>("-128", -128), "smallest int8_t");
+    check(isRejected<std::int8_t>("128"), "int8_t overflow");
+    check(isRejected<std::int8_t>("-129"), "int8_t underflow");
+    check(parses<std::int64_t>("9223372036854775807", std::numeric_limits<std::int64_t>::max()), "largest int64_t");
+    check(parses<std::int64_t>("-9223372036854775808", std::numeric_limits<std::int64_t>::min()), "smallest int64_t");
+    check(isRejected<std::int64_t>("9223372036854775808"), "int64_t overflow");
+    check(parses<std::uint64_t>("18446744073709551615", std::numeric_limits<std::uint64_t>::max()), "largest uint64_t");
+    check(isRejected<std::uint64_t>("18446744073709551616"), "uint64_t overflow");
+    check(isRejected<std::uint64_t>("99999999999999999999"), "uint64_t overflow by a digit");
+    check(isRejected<unsigned int>("-1"), "negative unsigned");
+    check(isRejected<int>("-"), "sign without digits");
+    check(isRejected<int>(""), "empty integer");
+    check(isRejected<int>("12a"), "trailing garbage");
+    check(parses<int>("-0", 0), "negative zero");
+    check(parses<int>("007", 7), "leading zeros");
+}
+
+static void checkCaseInsensitiveKeys()
+{
+    MDNSService service;
+    setServiceType<HttpService>(service);
+    service.addTxtRecord("PATH=/upper")
+        .addTxtRecord("path=/lower")
+        .addTxtRecord("Weight=7")
+        .addTxtRecord("SECURE")
+        .addTxtRecord("name=printer")
+        .addTxtRecord("txtvers=99999999999");
+
+    check(Schema::lookup(MDNSStringRef("PATH")) == Schema::indexOf<PathKey>(), "upper case key lookup");
+    check(Schema::lookup(MDNSStringRef("nAmE")) == Schema::indexOf<NameKey>(), "mixed case key lookup");
+
+    MDNSTxtView<Schema> txt(service);
+    check(txt.get<PathKey>() == "/upper", "first occurrence of a key wins regardless of case");
+    check(txt.get<WeightKey>() == 7, "mixed case key value");
+    check(txt.has<SecureKey>() && txt.get<SecureKey>(), "boolean attribute without value");
+    check(txt.get<NameKey>() == "printer", "lower case record of mixed case schema key");
+    check(txt.has<VersionKey>() && txt.get<VersionKey>() == 0, "overflowing value falls back to the default");
+
+    check(isServiceOfType<HttpService>(service), "service of the declared type");
+    service.setType("_HTTP._TCP");
+    check(isServiceOfType<HttpService>(service), "service type compared case-insensitively");
+    service.setType("_https._tcp");
+    check(!isServiceOfType<HttpService>(service), "service of a different type");
+}
+
+int main()
+{
+    checkWireNames();
+    checkPerfectHash();
+    checkIntegerParsing();
+    checkCaseInsensitiveKeys();
+
+    std::cout<<(failures ? "FAILED" : "OK")<<std::endl;
+    return failures ? 1 : 0;
+}